@@ -0,0 +1,34 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+
+// Monotonic memory for one bulk-loaded dataset. Allocating is a pointer bump
+// and freeing is a no-op, so loading thousands of small records costs a few
+// large blocks instead of one heap call each; everything goes back in one
+// release() when the dataset is dropped. Use it as the memory resource of
+// std::pmr containers that live exactly as long as the dataset. Blocks come
+// from upstream, which lets a tracking resource charge them to a subsystem.
+class Arena : public std::pmr::memory_resource {
+public:
+    explicit Arena(std::size_t initialBytes = 64 * 1024,
+                   std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // Free every block at once. Nothing allocated from the arena may be used
+    // afterwards.
+    void release();
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    std::mutex m_mutex;
+    std::pmr::monotonic_buffer_resource m_memory;
+};
+
+#endif // ARENA_HPP
@@ -0,0 +1,51 @@
+#ifndef CART_STORE_HPP
+#define CART_STORE_HPP
+
+#include <fstream>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "MemoryTracker.hpp"
+#include "StringTable.hpp"
+
+// Shopping carts keyed by username. Each cart line is just a stock ID and a
+// quantity, and every change is appended to a log file so carts survive a restart.
+class CartStore {
+public:
+    // One line of a cart: stock ID and quantity
+    struct Line {
+        int stockId;
+        int quantity;
+    };
+
+    // Replay the cart log from disk and open it for appending
+    void load(const std::string& filename);
+
+    // Lines of a user's cart (empty if the user has no cart)
+    std::vector<Line> getCart(const std::string& username) const;
+    bool isEmpty(const std::string& username) const;
+
+    // Add quantity of a stock item; returns the new quantity of that line
+    int addItem(const std::string& username, int stockId, int quantity);
+    void clear(const std::string& username);
+
+    // Number of users currently holding a non-empty cart
+    std::size_t getCartCount() const;
+
+private:
+    void applyAdd(StringTable::Handle user, int stockId, int quantity);
+    void append(const std::string& record);
+    void compact();
+
+    mutable std::mutex m_mutex;
+    // By interned username; the cart lines share the map's resource
+    std::pmr::unordered_map<StringTable::Handle, std::pmr::vector<Line>> m_carts{
+        MemoryTracker::resource(MemoryTracker::Subsystem::Carts)};
+    std::string m_filename;
+    std::ofstream m_log;
+    std::size_t m_logRecords = 0;
+};
+
+#endif // CART_STORE_HPP
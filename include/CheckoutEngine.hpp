@@ -0,0 +1,109 @@
+#ifndef CHECKOUT_ENGINE_HPP
+#define CHECKOUT_ENGINE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Stock.hpp"
+#include "TimerWheel.hpp"
+
+// Thread-safe checkout engine. Every SKU keeps its on-hand and reserved
+// quantities in one atomic word, so many cashiers can reserve and check out
+// at the same time without a global lock.
+class CheckoutEngine {
+public:
+    // One line of a cart: stock ID and the quantity to buy
+    struct Line {
+        int stockId;
+        int quantity;
+    };
+
+    CheckoutEngine();
+
+    // Rebuild the per-SKU counters from the catalog
+    void load(const std::pmr::vector<Stock>& stocks);
+
+    // Keep the engine in step with admin edits (add, update, delete)
+    void setQuantity(int stockId, int quantity);
+    void removeSku(int stockId);
+
+    // On-hand quantity of a SKU, or -1 if the SKU is unknown
+    int getQuantity(int stockId) const;
+    // On-hand quantity not held by any cart
+    int getAvailable(int stockId) const;
+    // Quantity held by cart reservations
+    int getReserved(int stockId) const;
+    // Quantity of a SKU currently held for one owner
+    int getReservedBy(const std::string& owner, int stockId);
+
+    // Hold quantity for a cart owner until the TTL runs out. Reserving the
+    // same SKU again adds to the hold and restarts its TTL.
+    bool reserve(const std::string& owner, int stockId, int quantity, int ttlSeconds);
+    // Give back everything an owner holds (cart cleared or abandoned)
+    void releaseAll(const std::string& owner);
+    // Release every reservation whose TTL has run out
+    void expireReservations();
+
+    // Take every line of the cart or none of them. Quantities never go below zero.
+    // The owner's reservations are used first, the rest comes from available stock.
+    // On failure the IDs of the lines that could not be satisfied are stored in failedIds.
+    bool checkout(const std::vector<Line>& lines, std::vector<int>& failedIds);
+    bool checkout(const std::string& owner, const std::vector<Line>& lines, std::vector<int>& failedIds);
+
+private:
+    // On-hand quantity in the high 32 bits, reserved quantity in the low 32 bits.
+    // Padded to a cache line so counters of neighbouring SKUs do not false-share.
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> word{0};
+    };
+
+    struct Reservation {
+        std::string owner;
+        int stockId;
+        int quantity;
+        TimerWheel::TimerId timer;
+    };
+
+    // Reservations are sharded by owner; each shard has its own timer wheel,
+    // so carts of different customers never contend on the same lock
+    struct Shard {
+        Shard();
+        std::mutex mutex;
+        TimerWheel wheel;
+        std::vector<Reservation> reservations;
+        std::vector<std::uint32_t> freeReservations;
+        std::unordered_map<std::string, std::vector<std::uint32_t>> byOwner;
+    };
+
+    static constexpr std::size_t SHARD_COUNT = 16;
+
+    static std::uint64_t pack(int onHand, int reserved);
+    static int onHandOf(std::uint64_t word);
+    static int reservedOf(std::uint64_t word);
+    static std::uint64_t nowTick();
+
+    // Atomic state transitions on one SKU; each returns false instead of going below zero
+    static bool tryTake(Slot& slot, int quantity);
+    static bool tryReserve(Slot& slot, int quantity);
+    static bool tryCommitReserved(Slot& slot, int quantity);
+    static void unreserve(Slot& slot, int quantity);
+
+    Slot* findSlot(int stockId) const;
+    Shard& shardFor(const std::string& owner);
+    void expireShard(Shard& shard);
+    void freeReservation(Shard& shard, std::uint32_t index);
+
+    // Guards the layout of the map only; the counters themselves are lock-free
+    mutable std::shared_mutex m_mutex;
+    std::unordered_map<int, std::unique_ptr<Slot>> m_slots;
+    std::array<Shard, SHARD_COUNT> m_shards;
+};
+
+#endif // CHECKOUT_ENGINE_HPP
@@ -2,6 +2,7 @@
 #define DISPLAY_UTIL_HPP
 
 #include <iostream>
+#include <memory_resource>
 #include <vector>
 #include <string>
 #include <tabulate/table.hpp>
@@ -15,10 +16,21 @@ public:
     // static void displayWelcome();
     
     // Display a list of users in a table
-    static void displayUsers(const std::vector<User>& users);
+    static void displayUsers(const std::pmr::vector<User>& users);
 
-    // Display a list of stocks in a table
-    static void displayStocks(const std::vector<Stock>& stocks);
+    // Rows shown per page of the stock catalog
+    static constexpr std::size_t CATALOG_PAGE_SIZE = 15;
+
+    // Display the stocks in [first, first + count) as one page of the catalog.
+    // Only the visible rows are formatted, so the cost does not grow with the
+    // catalog. Returns the number of lines printed.
+    static int displayStocks(const std::pmr::vector<Stock>& stocks, std::size_t first = 0,
+                             std::size_t count = CATALOG_PAGE_SIZE);
+
+    // Start of the page holding the first stock with ID >= id.
+    // The catalog is kept sorted by ID, so this is a binary search.
+    static std::size_t findStockPage(const std::pmr::vector<Stock>& stocks, int id,
+                                     std::size_t pageSize = CATALOG_PAGE_SIZE);
 
 private:
     // Helper function to create and print a table
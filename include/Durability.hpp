@@ -0,0 +1,62 @@
+#ifndef DURABILITY_HPP
+#define DURABILITY_HPP
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Crash-safe saves. A save writes a temporary file, syncs it, renames it over
+// the old file and syncs the directory, so after a crash the file holds either
+// the old or the new contents, never a mix.
+//
+// Syncing is what makes a save slow. With a batching window, saves are queued
+// and a background thread makes them durable once the window has passed; a
+// file saved several times within the window is written once, with its latest
+// contents. A crash can then lose at most the last window of saves, but never
+// corrupts a file. The default window of zero makes every save durable before
+// it returns.
+//
+// A queued save that fails is queued again, up to MAX_ATTEMPTS runs, unless a
+// newer save of the same file has replaced it. Failures are not printed: the
+// background thread must not touch the console (std::cerr flushes std::cout
+// into the screen renderer), so they are kept for the UI thread to collect
+// with takeErrors().
+class Durability {
+public:
+    static constexpr int MAX_ATTEMPTS = 3;
+    static constexpr std::size_t MAX_ERRORS = 64; // older messages are dropped
+
+    static void setBatchWindow(std::chrono::milliseconds window);
+    static std::chrono::milliseconds getBatchWindow();
+
+    // Write bytes to filename crash-safely, now or within the window
+    static bool writeFile(const std::string& filename, std::string bytes);
+    // The same, always now; for tasks that queue themselves
+    static bool writeFileNow(const std::string& filename, const std::string& bytes);
+    // Append bytes to filename and sync it, now. A crash can leave the last
+    // append cut short, so readers must be able to detect a torn end.
+    static bool appendFileNow(const std::string& filename, const std::string& bytes);
+    // Replace filename with an already written tempFile
+    static bool replaceFile(const std::string& tempFile, const std::string& filename);
+
+    static bool syncFile(const std::string& filename);
+    static bool syncDirectory(const std::string& directory);
+
+    // Run task now, or within the window when there is one. A task queued under
+    // the same key that has not run yet is replaced.
+    static bool schedule(const std::string& key, std::function<bool()> task);
+    // Run every queued task now, retries included, and wait for them (also
+    // done at exit). False if a queued save was given up on and not replaced
+    // by a later one that succeeded.
+    static bool flush();
+    // Drop the queued task for key; waits if it is running
+    static void cancel(const std::string& key);
+
+    // Record a save error; safe from any thread
+    static void reportError(const std::string& message);
+    // Errors recorded since the last call, oldest first
+    static std::vector<std::string> takeErrors();
+};
+
+#endif // DURABILITY_HPP
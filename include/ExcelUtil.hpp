@@ -2,6 +2,7 @@
 #define EXCEL_UTIL_HPP
 #define _CRT_SECURE_NO_WARNINGS
 
+#include <memory_resource>
 #include <vector>
 #include <string>
 #include <xlnt/xlnt.hpp>
@@ -9,22 +10,23 @@
 #include "Stock.hpp"
 #include "Receipt.hpp" // Include Receipt.hpp
 
-// Utility class for reading and writing data to Excel files
+// Utility class for reading and writing data to Excel files.
+// The write functions throw when the file cannot be saved.
 class ExcelUtil {
 public:
     // User file functions
-    static std::vector<User> readUsersFromFile(const std::string& filename);
-    static void writeUsersToFile(const std::string& filename, const std::vector<User>& users);
+    static std::pmr::vector<User> readUsersFromFile(const std::string& filename);
+    static void writeUsersToFile(const std::string& filename, const std::pmr::vector<User>& users);
     
     // Stock file functions
-    static std::vector<Stock> readStockFromFile(const std::string& filename);
-    static void writeStockToFile(const std::string& filename, const std::vector<Stock>& stocks);
-    static int getNextStockId(const std::vector<Stock>& stocks);
+    static std::pmr::vector<Stock> readStockFromFile(const std::string& filename);
+    static void writeStockToFile(const std::string& filename, const std::pmr::vector<Stock>& stocks);
+    static int getNextStockId(const std::pmr::vector<Stock>& stocks);
 
     // Transaction file functions (New)
-    static std::vector<Receipt> readTransactionsFromFile(const std::string& filename);
-    static void writeTransactionsToFile(const std::string& filename, const std::vector<Receipt>& receipts);
-    static int getNextReceiptId(const std::vector<Receipt>& receipts); // New: Get next receipt ID
+    static std::pmr::vector<Receipt> readTransactionsFromFile(const std::string& filename);
+    static void writeTransactionsToFile(const std::string& filename, const std::pmr::vector<Receipt>& receipts);
+    static int getNextReceiptId(const std::pmr::vector<Receipt>& receipts); // New: Get next receipt ID
 
 private:
     // Helper functions for file creation
@@ -0,0 +1,38 @@
+#ifndef LATENCY_HISTOGRAM_HPP
+#define LATENCY_HISTOGRAM_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// HDR-style latency histogram over microseconds. Values below 32 get a bucket
+// each; above that every power of two is split into 32 sub-buckets, so any
+// recorded value is reported within about 3% across the whole range.
+// Recording is a few atomic increments and never allocates or locks.
+class LatencyHistogram {
+public:
+    void record(std::uint64_t micros);
+
+    std::uint64_t getCount() const;
+    std::uint64_t getSumMicros() const;
+    std::uint64_t getMaxMicros() const;
+    // Value at quantile q (0..1), e.g. 0.99 for p99; 0 when empty
+    std::uint64_t getPercentile(double q) const;
+
+private:
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int MAX_EXPONENT = 40; // about 12 days in microseconds
+    static constexpr int BUCKET_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+    static int bucketOf(std::uint64_t micros);
+    // Middle of the range of values that land in a bucket
+    static std::uint64_t valueOf(int bucket);
+
+    std::array<std::atomic<std::uint64_t>, BUCKET_COUNT> m_buckets{};
+    std::atomic<std::uint64_t> m_count{0};
+    std::atomic<std::uint64_t> m_sum{0};
+    std::atomic<std::uint64_t> m_max{0};
+};
+
+#endif // LATENCY_HISTOGRAM_HPP
@@ -0,0 +1,73 @@
+#ifndef MEMORY_TRACKER_HPP
+#define MEMORY_TRACKER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <ostream>
+
+// Memory accounting per subsystem. Each subsystem has a counting memory
+// resource, and the std::pmr containers it owns allocate from it, so their
+// storage is charged to it wherever it is later freed. Records that own
+// strings keep them in the same resource (User); interned product names and
+// usernames are shared by every subsystem and charged to none.
+//
+// Allocations made inside libraries cannot be seen that way (xlnt lives in its
+// own DLL with its own heap), so Excel reports the growth of the process
+// working set across each workbook load or save instead.
+class MemoryTracker {
+public:
+    enum class Subsystem : std::uint8_t {
+        Users,
+        Stocks,
+        Receipts,
+        Carts,
+        Indexes,  // user, receipt-history and time indexes, restock rates
+        Excel,    // working-set growth while xlnt loads or saves a workbook
+        COUNT
+    };
+    static constexpr int SUBSYSTEM_COUNT = static_cast<int>(Subsystem::COUNT);
+
+    // For Excel: liveBytes is the growth of the last measured operation,
+    // peakBytes the largest growth seen and allocations the operations measured
+    struct Usage {
+        std::uint64_t liveBytes;
+        std::uint64_t peakBytes;
+        std::uint64_t allocations;
+        std::uint64_t frees;
+    };
+
+    // Resource for the containers of a subsystem; valid for the whole program
+    static std::pmr::memory_resource* resource(Subsystem subsystem);
+
+    static const char* getName(Subsystem subsystem);
+    static Usage getUsage(Subsystem subsystem);
+    // All counting resources together (Excel is not included); its peak is the
+    // highest total, not the sum of the peaks
+    static Usage getTotal();
+
+    // Gauges for every subsystem in the Prometheus text format
+    static void writePrometheus(std::ostream& out);
+
+    // Resident memory of the process in bytes, 0 if unknown
+    static std::uint64_t getWorkingSet();
+
+    // Records the working-set growth from construction to stop() or destruction
+    // as the usage of a subsystem
+    class WorkingSetProbe {
+    public:
+        explicit WorkingSetProbe(Subsystem subsystem);
+        ~WorkingSetProbe();
+        WorkingSetProbe(const WorkingSetProbe&) = delete;
+        WorkingSetProbe& operator=(const WorkingSetProbe&) = delete;
+
+        void stop();
+
+    private:
+        Subsystem m_subsystem;
+        std::uint64_t m_start;
+        bool m_active;
+    };
+};
+
+#endif // MEMORY_TRACKER_HPP
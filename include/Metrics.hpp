@@ -0,0 +1,46 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <chrono>
+#include <string>
+#include "LatencyHistogram.hpp"
+
+// Process-wide operation latencies, exported in the Prometheus text format
+// so the host can scrape them (e.g. with node_exporter's textfile collector).
+class Metrics {
+public:
+    // Histogram for an operation, created on first use; the reference stays valid
+    static LatencyHistogram& histogram(const std::string& operation);
+
+    // Times a block: records from construction until stop() or destruction.
+    // The name form looks the histogram up under a lock on every use; hot paths
+    // keep the reference instead:
+    //   static LatencyHistogram& latency = Metrics::histogram("lookup");
+    //   Metrics::ScopedTimer timer(latency);
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(const std::string& operation);
+        explicit ScopedTimer(LatencyHistogram& histogram);
+        ~ScopedTimer();
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        void stop();
+
+    private:
+        LatencyHistogram* m_histogram;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    // Write every histogram (p50/p99/p999, max, sum, count) and the memory use
+    // of each subsystem to filename.
+    // The file is replaced atomically, so a scraper never reads half of it.
+    static bool writePrometheus(const std::string& filename);
+
+    // Rewrite the file every intervalSeconds on a background thread, and once
+    // more when the program exits
+    static void startPeriodicExport(const std::string& filename, int intervalSeconds);
+    static void stopPeriodicExport();
+};
+
+#endif // METRICS_HPP
@@ -0,0 +1,50 @@
+#ifndef MONEY_HPP
+#define MONEY_HPP
+
+#include <cstdint>
+#include <string>
+
+// Fixed-point amount of money stored as a whole number of cents.
+// Sums and products are exact integer arithmetic, so totals over long
+// histories never drift and summing loops can be vectorised by the compiler.
+class Money {
+public:
+    // Buffer size that fits any formatted amount
+    static constexpr std::size_t FORMAT_SIZE = 24;
+
+    constexpr Money() : m_cents(0) {}
+
+    static constexpr Money fromCents(std::int64_t cents) { return Money(cents); }
+    // Round a floating-point amount (e.g. a numeric spreadsheet cell) to the nearest cent
+    static Money fromDouble(double amount);
+    // Parse "123", "-4.5" or "12.345" (rounded half up to cents); returns false on bad input
+    static bool parse(const std::string& text, Money& out);
+
+    constexpr std::int64_t getCents() const { return m_cents; }
+    // For places that need a plain number, such as numeric spreadsheet cells
+    constexpr double toDouble() const { return m_cents / 100.0; }
+    // Always two decimals, e.g. "1234.50" or "-0.05"
+    std::string toString() const;
+    // Same text as toString() written into buffer; returns its length
+    std::size_t format(char (&buffer)[FORMAT_SIZE]) const;
+
+    constexpr Money operator+(Money other) const { return Money(m_cents + other.m_cents); }
+    constexpr Money operator-(Money other) const { return Money(m_cents - other.m_cents); }
+    constexpr Money operator*(std::int64_t quantity) const { return Money(m_cents * quantity); }
+    Money& operator+=(Money other) { m_cents += other.m_cents; return *this; }
+    Money& operator-=(Money other) { m_cents -= other.m_cents; return *this; }
+
+    constexpr bool operator==(Money other) const { return m_cents == other.m_cents; }
+    constexpr bool operator!=(Money other) const { return m_cents != other.m_cents; }
+    constexpr bool operator<(Money other) const { return m_cents < other.m_cents; }
+    constexpr bool operator>(Money other) const { return m_cents > other.m_cents; }
+    constexpr bool operator<=(Money other) const { return m_cents <= other.m_cents; }
+    constexpr bool operator>=(Money other) const { return m_cents >= other.m_cents; }
+
+private:
+    constexpr explicit Money(std::int64_t cents) : m_cents(cents) {}
+
+    std::int64_t m_cents;
+};
+
+#endif // MONEY_HPP
@@ -1,35 +1,58 @@
 #ifndef RECEIPT_HPP
 #define RECEIPT_HPP
 
+#include <memory_resource>
 #include <string>
 #include <vector>
 #include <chrono>
+#include <ctime>
+#include "Money.hpp"
 #include "Stock.hpp"
+#include "StringTable.hpp"
 
 class Receipt {
 public:
-    // A pair of Stock item and its purchased quantity
-    using Item = std::pair<Stock, int>;
+    // One purchased line: item ID, quantity, the unit price paid and the
+    // product name at the time of sale, interned so a line stays small.
+    struct Item {
+        int itemId;
+        int quantity;
+        Money unitPrice;
+        StringTable::Handle name;
 
-    // Constructor
+        const std::string& getName() const;
+    };
+
+    // Constructors (the first one stamps the receipt with the current time).
+    // The items are copied into the receipt history's arena and the username is
+    // interned, so callers can reuse their item vector for the next receipt.
     Receipt(int receiptId, const std::vector<Item>& items, const std::string& username);
+    Receipt(int receiptId, const std::vector<Item>& items, const std::string& username, std::time_t transactionTime);
+
+    // Build a receipt line from a catalog item as it is now
+    static Item makeItem(const Stock& stock, int quantity);
+
+    // Name on the most recent receipt line for an item ID, for reports that
+    // group sales by ID. A receipt's own lines keep their own names.
+    static const std::string& getLatestItemName(int itemId);
 
     // Getters
     int getReceiptId() const;
-    const std::vector<Item>& getItems() const;
-    double getTotalPrice() const;
+    const std::pmr::vector<Item>& getItems() const;
+    Money getTotalPrice() const;
     std::time_t getTransactionTime() const;
-    std::string getUsername() const; // Added getter for username
+    const std::string& getUsername() const; // Added getter for username
+    StringTable::Handle getUsernameHandle() const; // equal users, equal handles
     
 private:
     int receiptId_;
-    std::vector<Item> items_;
-    double totalPrice_;
+    std::pmr::vector<Item> items_; // allocated from the receipt history's arena
+    Money totalPrice_;
     std::time_t transactionTime_;
-    std::string username_; // Added username member
+    StringTable::Handle username_;
 
     // Private helper function to calculate the total price
-    double calculateTotalPrice() const;
+    Money calculateTotalPrice() const;
 };
 
 #endif // RECEIPT_HPP
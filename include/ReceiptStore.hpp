@@ -0,0 +1,37 @@
+#ifndef RECEIPT_STORE_HPP
+#define RECEIPT_STORE_HPP
+
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "Receipt.hpp"
+
+// Compact binary file for the receipt history. The body is laid out column
+// by column:
+//   receipt IDs and timestamps   delta-encoded varints
+//   usernames                    dictionary codes, bit-packed
+//   lines per receipt            varints
+//   items                        dictionary codes, bit-packed
+//   quantities, unit prices      bit-packed (prices as whole cents)
+// The item dictionary holds one entry per (item ID, name) pair, so a line
+// keeps the name it was sold under after a rename or an ID reuse.
+//
+// A sale appends one framed receipt (length, fields, checksum) after the body
+// instead of re-encoding the whole history, so its cost does not grow with
+// the history. load() reads the appended receipts too, drops a record cut
+// short by a crash, and folds them into a new body.
+//
+// The file is memory-mapped and decoded in one pass. Writes go through
+// Durability, so a crash never leaves a half-written body.
+class ReceiptStore {
+public:
+    // Write the whole history as a new body
+    static bool save(const std::string& filename, const std::pmr::vector<Receipt>& receipts);
+    // Persist receipts.back(), the receipt just added. Writes a full body
+    // instead if the file does not exist yet.
+    static bool append(const std::string& filename, const std::pmr::vector<Receipt>& receipts);
+    // Replaces receipts with the file's contents; false if the file is missing or damaged
+    static bool load(const std::string& filename, std::pmr::vector<Receipt>& receipts);
+};
+
+#endif // RECEIPT_STORE_HPP
@@ -0,0 +1,51 @@
+#ifndef RECEIPT_TIME_INDEX_HPP
+#define RECEIPT_TIME_INDEX_HPP
+
+#include <ctime>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+#include "MemoryTracker.hpp"
+#include "Receipt.hpp"
+
+// Receipts ordered by transaction time. Entries are kept in one sorted run
+// with the offset of the first entry of every (UTC) day, so "all receipts
+// between T1 and T2" is a day lookup, a binary search inside that day and a
+// contiguous scan, without touching the rest of the history.
+class ReceiptTimeIndex {
+public:
+    struct Entry {
+        std::time_t time;
+        std::size_t position; // index into the receipts vector
+    };
+
+    // Index the whole receipts vector
+    void rebuild(const std::pmr::vector<Receipt>& receipts);
+    // Index a receipt that was appended at the given position
+    void add(const Receipt& receipt, std::size_t position);
+
+    // Entries with from <= time < to, in time order, as a contiguous range
+    std::pair<const Entry*, const Entry*> getRange(std::time_t from, std::time_t to) const;
+    // Receipt positions with from <= time < to, in time order
+    std::vector<std::size_t> findRange(std::time_t from, std::time_t to) const;
+    std::size_t countInRange(std::time_t from, std::time_t to) const;
+
+    // All entries, oldest first
+    const std::pmr::vector<Entry>& getEntries() const;
+
+private:
+    struct DayOffset {
+        long long day;     // days since 1970-01-01 UTC
+        std::size_t begin; // first entry of that day
+    };
+
+    static long long dayOf(std::time_t time);
+    // Index of the first entry with time >= t
+    std::size_t lowerBound(std::time_t t) const;
+    void rebuildDayOffsets(std::size_t fromEntry);
+
+    std::pmr::vector<Entry> m_entries{MemoryTracker::resource(MemoryTracker::Subsystem::Indexes)};
+    std::pmr::vector<DayOffset> m_days{MemoryTracker::resource(MemoryTracker::Subsystem::Indexes)};
+};
+
+#endif // RECEIPT_TIME_INDEX_HPP
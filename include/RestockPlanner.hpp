@@ -0,0 +1,56 @@
+#ifndef RESTOCK_PLANNER_HPP
+#define RESTOCK_PLANNER_HPP
+
+#include <ctime>
+#include <memory_resource>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "MemoryTracker.hpp"
+#include "Receipt.hpp"
+#include "Stock.hpp"
+
+// Restock planning from sales velocity. Each item keeps an exponentially
+// weighted moving average of units sold per day (continuous-time, so sales
+// can arrive in any order). Planning runs as one batch over the catalog:
+// the inputs are gathered into flat arrays and every step is a simple loop
+// the compiler can vectorise.
+class RestockPlanner {
+public:
+    struct Recommendation {
+        int stockId;
+        double dailyVelocity;     // units per day, EWMA
+        double daysUntilStockout; // negative when the item is not selling
+        int suggestedOrder;       // units to order to cover lead time + cover days
+    };
+
+    explicit RestockPlanner(double halfLifeDays = 7.0, double leadTimeDays = 3.0, double coverDays = 14.0);
+
+    // Replay the whole history (order does not matter)
+    void rebuild(const std::pmr::vector<Receipt>& receipts);
+    void addReceipt(const Receipt& receipt);
+    void recordSale(int stockId, int units, std::time_t time);
+
+    // One recommendation per catalog item, in catalog order
+    std::vector<Recommendation> plan(const std::pmr::vector<Stock>& stocks, std::time_t now) const;
+
+    double getLeadTimeDays() const;
+    double getCoverDays() const;
+
+private:
+    void recordSaleLocked(int stockId, int units, double dayTime);
+
+    double m_tauDays;  // EWMA time constant = half-life / ln 2
+    double m_leadTimeDays;
+    double m_coverDays;
+
+    // Structure of arrays, one slot per item that has ever sold
+    mutable std::mutex m_mutex;
+    std::pmr::unordered_map<int, std::size_t> m_slots{MemoryTracker::resource(MemoryTracker::Subsystem::Indexes)};
+    // Units per day as of m_lastDay
+    std::pmr::vector<double> m_rate{MemoryTracker::resource(MemoryTracker::Subsystem::Indexes)};
+    // Time of the last update, in days since the epoch
+    std::pmr::vector<double> m_lastDay{MemoryTracker::resource(MemoryTracker::Subsystem::Indexes)};
+};
+
+#endif // RESTOCK_PLANNER_HPP
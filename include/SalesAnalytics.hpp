@@ -0,0 +1,89 @@
+#ifndef SALES_ANALYTICS_HPP
+#define SALES_ANALYTICS_HPP
+
+#include <ctime>
+#include <map>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Money.hpp"
+#include "Receipt.hpp"
+#include "StringTable.hpp"
+
+// Sales rollups over the receipts history: revenue per day, week and month,
+// units sold per item, revenue per user and basket averages. The history is
+// aggregated once in parallel, then every new receipt is folded in, so
+// queries only touch the rollups and never rescan the receipts.
+class SalesAnalytics {
+public:
+    // Totals of one calendar period
+    struct Period {
+        std::string label; // "2024-05-17" for a day or week start, "2024-05" for a month
+        Money revenue;
+        long long units = 0;
+        long long receipts = 0;
+    };
+
+    // Aggregate the whole history, splitting it over worker threads
+    void build(const std::pmr::vector<Receipt>& receipts);
+    // Fold one new receipt into the rollups
+    void addReceipt(const Receipt& receipt);
+
+    // The most recent periods that had sales, oldest first
+    std::vector<Period> getDaily(std::size_t count) const;
+    std::vector<Period> getWeekly(std::size_t count) const;   // weeks start on Monday
+    std::vector<Period> getMonthly(std::size_t count) const;
+
+    // Totals of the day, week and month containing the given time
+    Period getDayOf(std::time_t time) const;
+    Period getWeekOf(std::time_t time) const;
+    Period getMonthOf(std::time_t time) const;
+
+    long long getUnitsSold(int itemId) const;
+    Money getRevenueForUser(const std::string& username) const;
+    std::vector<std::pair<int, long long>> getTopItemsByUnits(std::size_t count) const;
+    std::vector<std::pair<std::string, Money>> getTopUsersByRevenue(std::size_t count) const;
+
+    Money getTotalRevenue() const;
+    long long getReceiptCount() const;
+    double getAverageBasketUnits() const;
+    Money getAverageBasketValue() const;
+
+private:
+    struct Bucket {
+        Money revenue;
+        long long units = 0;
+        long long receipts = 0;
+    };
+
+    // Everything derived from a set of receipts; partial rollups of
+    // partitions are merged into one
+    struct Rollup {
+        std::map<long long, Bucket> byDay;   // key: days since 1970-01-01 (local date)
+        std::map<long long, Bucket> byWeek;  // key: day number of the week's Monday
+        std::map<long long, Bucket> byMonth; // key: year * 12 + month - 1
+        std::unordered_map<int, long long> unitsByItem;
+        std::unordered_map<StringTable::Handle, Money> revenueByUser; // by interned username
+        Money totalRevenue;
+        long long totalUnits = 0;
+        long long receiptCount = 0;
+
+        void add(const Receipt& receipt);
+        void merge(const Rollup& other);
+    };
+
+    static bool dayNumber(std::time_t time, long long& day, long long& month);
+    static std::string dayLabel(long long day);
+    static std::string monthLabel(long long month);
+    static std::vector<Period> lastPeriods(const std::map<long long, Bucket>& buckets, std::size_t count,
+                                           std::string (*label)(long long));
+    static Period periodOf(const std::map<long long, Bucket>& buckets, long long key, std::string label);
+
+    mutable std::mutex m_mutex;
+    Rollup m_rollup;
+};
+
+#endif // SALES_ANALYTICS_HPP
@@ -0,0 +1,77 @@
+#ifndef SCREEN_RENDERER_HPP
+#define SCREEN_RENDERER_HPP
+
+#include <streambuf>
+#include <string>
+#include <vector>
+
+// Frame-buffered console output. Once installed, everything written to
+// std::cout collects in an off-screen buffer and goes to the terminal in one
+// write when the stream is flushed (explicitly, by std::endl, or before
+// std::cin reads). clearScreen() starts a new frame without spawning a shell;
+// when the frame is presented it is compared line by line with the previous
+// frame and only the lines that changed are redrawn.
+class ScreenRenderer {
+public:
+    // Route std::cout through the frame buffer (call once at startup)
+    static void install();
+
+    // Start a new frame; replaces system("cls")
+    static void clearScreen();
+    // Move the cursor to column x, row y (0-based), in order with buffered text
+    static void moveCursor(int x, int y);
+    // Send everything buffered so far with a single write
+    static void present();
+
+    // printf into the frame buffer, so it stays in order with std::cout
+    static int printf(const char* format, ...);
+
+private:
+    // One terminal row: the colour escapes active when it starts, and its bytes
+    struct Line {
+        std::string style;
+        std::string text;
+        bool operator==(const Line& other) const {
+            return style == other.style && text == other.text;
+        }
+    };
+
+    // std::cout writes land here instead of going straight to the console
+    class FrameBuffer : public std::streambuf {
+    protected:
+        int_type overflow(int_type ch) override;
+        std::streamsize xsputn(const char* s, std::streamsize count) override;
+        int sync() override;
+    };
+
+    ScreenRenderer() = default;
+    ~ScreenRenderer();
+    static ScreenRenderer& instance();
+
+    void append(const char* s, std::size_t count);
+    void flush();
+    // Turn the pending frame into the escapes that update the screen
+    void finishFrame();
+    // Account for rows touched by output written since the frame was drawn
+    void track();
+
+    static bool splitLines(const std::string& frame, const std::string& style, std::vector<Line>& lines);
+    static int displayWidth(const std::string& text);
+    static bool terminalSize(int& columns, int& rows);
+    static void writeOut(const std::string& bytes);
+
+    FrameBuffer m_buffer;
+    std::streambuf* m_original = nullptr;
+    std::string m_pending;         // bytes not yet written
+    std::size_t m_tracked = 0;     // bytes of m_pending already passed to track()
+    std::size_t m_frameStart = 0;  // offset of the open frame in m_pending
+    bool m_frameOpen = false;
+    std::string m_style;           // colour escapes in effect on the terminal
+    std::string m_frameStyle;      // colour escapes in effect where the frame starts
+    std::vector<Line> m_previous;  // last frame drawn
+    std::size_t m_validRows = 0;   // top rows of the screen that still match m_previous
+    std::size_t m_cursorRow = 0;   // lowest row later output can start on
+    std::size_t m_flushesSinceFrame = 0; // each may be followed by an input line
+};
+
+#endif // SCREEN_RENDERER_HPP
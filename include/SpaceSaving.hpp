@@ -0,0 +1,39 @@
+#ifndef SPACE_SAVING_HPP
+#define SPACE_SAVING_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Space-Saving heavy-hitters summary (Metwally et al.) with weighted updates.
+// Tracks at most `capacity` keys; when full, the key with the smallest count
+// is evicted and the newcomer inherits that count as its error bound. Any key
+// whose true total exceeds total/capacity is guaranteed to be tracked.
+class SpaceSaving {
+public:
+    struct Counter {
+        int key;
+        long long count; // overestimate of the true total
+        long long error; // count - error <= true total <= count
+    };
+
+    explicit SpaceSaving(std::size_t capacity = 64);
+
+    void offer(int key, long long weight);
+    void clear();
+
+    // Tracked counters in no particular order
+    const std::vector<Counter>& getCounters() const;
+    std::size_t getCapacity() const;
+
+private:
+    // m_counters is a binary min-heap on count; m_positions maps a key to its heap slot
+    void siftDown(std::size_t index);
+    void swapCounters(std::size_t a, std::size_t b);
+
+    std::size_t m_capacity;
+    std::vector<Counter> m_counters;
+    std::unordered_map<int, std::size_t> m_positions;
+};
+
+#endif // SPACE_SAVING_HPP
@@ -1,34 +1,50 @@
 #ifndef STOCK_HPP
 #define STOCK_HPP
 
+#include <cstdint>
 #include <string>
+#include "Money.hpp"
+#include "StringTable.hpp"
 
 // A class to represent an item in stock
 class Stock {
 public:
+    // Reorder threshold given to items that do not set their own
+    static constexpr int DEFAULT_REORDER_THRESHOLD = 20;
+
     // Default constructor
     Stock();
 
     // Parameterized constructor
-    Stock(int id, const std::string& name, int quantity, double price);
+    Stock(int id, const std::string& name, int quantity, Money price,
+          int reorderThreshold = DEFAULT_REORDER_THRESHOLD);
 
     // Getters for stock properties
     int getId() const;
-    std::string getName() const;
+    const std::string& getName() const;
+    // Interned name: equal names have equal handles
+    StringTable::Handle getNameHandle() const;
     int getQuantity() const;
-    double getPrice() const;
+    Money getPrice() const;
+    int getReorderThreshold() const; // low-stock alert fires below this quantity
+    // Changes whenever any field changes and is never reused by another
+    // record, so (ID, version) identifies what a cached rendering shows
+    std::uint64_t getVersion() const;
 
     // Setters for stock properties
     void setId(int id);
     void setName(const std::string& name);
     void setQuantity(int quantity);
-    void setPrice(double price);
+    void setPrice(Money price);
+    void setReorderThreshold(int reorderThreshold);
 
 private:
     int m_id;
-    std::string m_name;
+    StringTable::Handle m_name;
     int m_quantity;
-    double m_price;
+    Money m_price;
+    int m_reorderThreshold;
+    std::uint64_t m_version;
 };
 
 #endif // STOCK_HPP
@@ -0,0 +1,47 @@
+#ifndef STOCK_ALERTS_HPP
+#define STOCK_ALERTS_HPP
+
+#include <deque>
+#include <fstream>
+#include <memory_resource>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#include "Stock.hpp"
+
+// Event-driven low-stock alerts. Callers report every quantity or threshold
+// change as it happens; an alert is raised only when the change crosses the
+// item's reorder threshold, appended to the alert log immediately, and the
+// set of items below threshold is kept current, so no screen has to scan the
+// catalog to find low stock.
+class StockAlerts {
+public:
+    // Open (append) the alert log and seed the low-stock set from the catalog
+    void open(const std::string& logFile, const std::pmr::vector<Stock>& stocks);
+
+    // Report changes; oldQuantity/oldThreshold are the values before the change
+    void onAdded(const Stock& stock);
+    void onQuantityChange(const Stock& stock, int oldQuantity);
+    void onThresholdChange(const Stock& stock, int oldThreshold);
+    void onRemoved(int stockId);
+
+    // IDs of items currently below their reorder threshold, ascending
+    std::vector<int> getLowStockIds() const;
+    std::size_t getLowStockCount() const;
+    // Most recent alert lines, newest last
+    std::vector<std::string> getRecentAlerts(std::size_t count) const;
+
+private:
+    static constexpr std::size_t RECENT_ALERTS = 50;
+
+    void evaluate(const Stock& stock, bool wasLow, int oldQuantity);
+    void raise(const std::string& kind, const Stock& stock);
+
+    mutable std::mutex m_mutex;
+    std::set<int> m_lowStock;
+    std::deque<std::string> m_recent;
+    std::ofstream m_log;
+};
+
+#endif // STOCK_ALERTS_HPP
@@ -0,0 +1,139 @@
+#ifndef STOCK_DB_HPP
+#define STOCK_DB_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <list>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Stock.hpp"
+
+// Page-based B+tree file holding the stock catalog, keyed by stock ID.
+//
+// Pages are never changed in place once committed: a write copies the pages
+// on the path from the leaf to the root, and a commit writes those copies,
+// syncs, and then switches to the new root by writing one of two meta pages.
+// A crash at any point leaves the previous commit intact. Recently read pages
+// stay decoded in a small LRU buffer pool, so lookups and updates only touch
+// the pages on one root-to-leaf path. With a Durability batching window, the
+// writes made within the window share one transaction and one commit; if that
+// commit fails, the batch is kept and Durability runs the commit again.
+//
+// The program loads the whole catalog once at startup and serves lookups,
+// paging and checkout from that copy; the file is where every change is
+// written. get() reads single records from disk for callers without it.
+class StockDb {
+public:
+    static constexpr std::size_t PAGE_SIZE = 4096;
+    static constexpr std::size_t MAX_NAME_LENGTH = 1024; // keeps at least three records per leaf
+    static constexpr std::size_t POOL_PAGES = 64;
+
+    StockDb() = default;
+    ~StockDb();
+    StockDb(const StockDb&) = delete;
+    StockDb& operator=(const StockDb&) = delete;
+
+    // Open or create the file; false if it cannot be opened or is not a catalog
+    bool open(const std::string& filename);
+    void close();
+    bool isOpen() const;
+
+    // Read one record straight from the file (through the buffer pool)
+    bool get(int id, Stock& stock);
+    // Insert or replace records; each call is one commit, or joins the batch
+    bool put(const Stock& stock);
+    bool putAll(const std::pmr::vector<Stock>& stocks);
+    bool erase(int id);
+
+    // Every record in ID order; false if a page is damaged, leaving stocks empty
+    bool loadAll(std::pmr::vector<Stock>& stocks);
+    std::uint64_t getRecordCount() const;
+
+private:
+    using PageId = std::uint32_t;
+    static constexpr PageId NO_PAGE = 0; // pages 0 and 1 are the meta pages
+
+    struct Node {
+        bool leaf = true;
+        std::vector<int> keys;          // leaf: record IDs; internal: separators
+        std::vector<Stock> records;     // leaf only, parallel to keys
+        std::vector<PageId> children;   // internal only, keys.size() + 1 entries
+    };
+    using NodePtr = std::shared_ptr<Node>;
+
+    // Committed state, as recorded in a meta page
+    struct Meta {
+        std::uint64_t txn = 0;
+        PageId root = NO_PAGE;
+        PageId pageCount = 2;
+        std::uint32_t height = 0;   // levels; every leaf is at the same depth
+        std::uint64_t recordCount = 0;
+    };
+
+    // Result of changing a subtree: its new page, and a right sibling if it split
+    struct Change {
+        bool removed = false;
+        PageId page = NO_PAGE;
+        int separator = 0;
+        PageId right = NO_PAGE;
+    };
+
+    bool find(int id, Stock& stock);
+    // Whether every page on the way to id can be read, checked before a
+    // write starts changing pages
+    bool checkPath(int id);
+    NodePtr readNode(PageId page);
+    void cache(PageId page, NodePtr node);
+    // The node at page, made safe to change in this transaction; page may move
+    NodePtr writableNode(PageId& page);
+    PageId allocatePage();
+    PageId storeNode(NodePtr node);
+    Change finish(PageId page, NodePtr node);
+
+    Change insert(PageId page, const Stock& stock, bool& added);
+    Change remove(PageId page, int id);
+    bool collect(PageId page, std::pmr::vector<Stock>& out);
+    // Marks the pages of a subtree without reading its leaves
+    void markReachable(PageId page, std::uint32_t depth, std::vector<bool>& reachable);
+    void closeFile();
+
+    void begin();
+    // Commit now, or leave the transaction open until the window passes
+    bool finishWrite(bool& scheduleCommit);
+    void scheduleCommit();
+    bool commitPending();
+    // Leaves the transaction as it is on failure; the caller retries or rolls back
+    bool commit();
+    void rollback();
+
+    bool readMeta(PageId slot, Meta& meta);
+    bool writePage(PageId page, const std::string& bytes);
+    bool readPage(PageId page, std::string& bytes);
+    bool sync();
+
+    static std::size_t encodedSize(const Node& node);
+    static std::string encode(const Node& node);
+    static NodePtr decode(const std::string& bytes);
+
+    mutable std::mutex m_mutex;
+    std::FILE* m_file = nullptr;
+    std::string m_filename;
+    bool m_pending = false;                   // a batched transaction awaits its commit
+    bool m_scheduled = false;                 // its commit is queued with Durability
+    Meta m_meta;                              // last commit
+    Meta m_working;                           // transaction in progress; what reads see
+    std::vector<PageId> m_free;               // pages no committed tree uses
+    std::vector<PageId> m_freeAtBegin;
+    std::vector<PageId> m_freedThisTxn;       // reusable once this transaction commits
+    std::unordered_map<PageId, NodePtr> m_dirty; // written by this transaction
+
+    // Buffer pool of committed pages, most recently used first
+    std::list<std::pair<PageId, NodePtr>> m_lru;
+    std::unordered_map<PageId, std::list<std::pair<PageId, NodePtr>>::iterator> m_pool;
+};
+
+#endif // STOCK_DB_HPP
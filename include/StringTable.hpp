@@ -0,0 +1,28 @@
+#ifndef STRING_TABLE_HPP
+#define STRING_TABLE_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Process-wide interned strings. Each distinct text is stored once and named
+// by a 32-bit handle, so records that repeat a product name or username hold
+// four bytes instead of a std::string, and equal texts compare as equal
+// handles. Strings are never removed; a handle and the reference returned by
+// get() stay valid until exit. Reading by handle takes no lock.
+class StringTable {
+public:
+    using Handle = std::uint32_t;
+    static constexpr Handle EMPTY = 0; // handle of ""
+
+    // Handle of text, adding it on first sight
+    static Handle intern(std::string_view text);
+    // Handle of text if it was ever interned; does not add it
+    static bool lookup(std::string_view text, Handle& handle);
+    static const std::string& get(Handle handle);
+
+    // Number of distinct strings, including ""
+    static std::size_t size();
+};
+
+#endif // STRING_TABLE_HPP
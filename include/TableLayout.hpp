@@ -0,0 +1,154 @@
+#ifndef TABLE_LAYOUT_HPP
+#define TABLE_LAYOUT_HPP
+
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <ostream>
+#include <string_view>
+#include <type_traits>
+#include "Money.hpp"
+
+// Shared screen geometry and table formatting. Every screen draws an 82-column
+// box centred in a 164-column terminal; the helpers here write straight into
+// the output stream instead of building a temporary string per line.
+namespace Layout {
+
+constexpr int TABLE_WIDTH = 82;     // inside width of box
+constexpr int TERMINAL_WIDTH = 164; // adjust for your terminal width
+constexpr int LEFT_PADDING = (TERMINAL_WIDTH - (TABLE_WIDTH + 4)) / 2; // +4 for borders
+
+// LEFT_PADDING spaces, for printf-style rows
+const char* margin();
+// Write count spaces
+void fill(std::ostream& out, int count);
+
+// cout << padLeft(text): the text indented by the left margin
+struct Indented {
+    std::string_view text;
+};
+inline Indented padLeft(std::string_view text) { return Indented{text}; }
+std::ostream& operator<<(std::ostream& out, const Indented& indented);
+
+// cout << centerText(text): the text centred in the box. Width is counted in
+// bytes, as the screens have always done; emoji lines add their own padding.
+struct Centered {
+    std::string_view text;
+    int width;
+};
+inline Centered centerText(std::string_view text, int width = TABLE_WIDTH) { return Centered{text, width}; }
+std::ostream& operator<<(std::ostream& out, const Centered& centered);
+
+enum class Align { Left, Center, Right };
+enum class Color { Default, Red, Green, Yellow, Blue, Magenta, Cyan, White };
+const char* escape(Color color);
+
+// One column of a table: width in characters (between separators), alignment,
+// colour and the number of decimals shown for floating-point values
+template <int Width, Align A = Align::Left, Color C = Color::Default, int Precision = 1>
+struct Column {
+    static_assert(Width >= 3, "column too narrow");
+    static constexpr int width = Width;
+    static constexpr Align align = A;
+    static constexpr Color color = C;
+    static constexpr int precision = Precision;
+};
+
+// A value shown in a colour other than its column's, e.g. a warning quantity
+template <typename T>
+struct Tinted {
+    const T& value;
+    Color color;
+};
+template <typename T>
+Tinted<T> tint(const T& value, Color color) { return Tinted<T>{value, color}; }
+
+// Write text into a cell of the given width: one space of padding on the side
+// it is aligned to, cut with "..." when it does not fit
+void writeCell(std::ostream& out, std::string_view text, int width, Align align);
+
+// Cell text of a value, formatted into buffer when it is not already a string
+constexpr std::size_t CELL_BUFFER = 32;
+inline std::string_view cellText(std::string_view text, char (&)[CELL_BUFFER], int) { return text; }
+inline std::string_view cellText(Money amount, char (&buffer)[CELL_BUFFER], int) {
+    char formatted[Money::FORMAT_SIZE];
+    std::size_t length = amount.format(formatted);
+    buffer[0] = '$';
+    std::char_traits<char>::copy(buffer + 1, formatted, length);
+    return std::string_view(buffer, length + 1);
+}
+template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+std::string_view cellText(T number, char (&buffer)[CELL_BUFFER], int) {
+    auto result = std::to_chars(buffer, buffer + CELL_BUFFER, number);
+    return std::string_view(buffer, static_cast<std::size_t>(result.ptr - buffer));
+}
+inline std::string_view cellText(double number, char (&buffer)[CELL_BUFFER], int precision) {
+    int length = std::snprintf(buffer, CELL_BUFFER, "%.*f", precision, number);
+    return std::string_view(buffer, length < 0 ? 0 : static_cast<std::size_t>(length));
+}
+
+// A box table whose columns are fixed at compile time. Rows go straight to the
+// stream; the trailing padding up to the right border is a constant.
+//
+//   using StockTable = Layout::TableLayout<Layout::Column<6, Layout::Align::Center>,
+//                                          Layout::Column<30>>;
+//   StockTable::header(cout, "ID", "Product Name");
+//   StockTable::row(cout, stock.getId(), stock.getName());
+template <typename... Columns>
+class TableLayout {
+public:
+    static constexpr int CONTENT_WIDTH = (Columns::width + ...) + static_cast<int>(sizeof...(Columns)) - 1;
+    static_assert(CONTENT_WIDTH <= TABLE_WIDTH, "columns wider than the box");
+    static constexpr int TRAILING = TABLE_WIDTH - CONTENT_WIDTH;
+
+    // Column titles, centred, in one colour
+    template <typename... Titles>
+    static void header(std::ostream& out, Color color, const Titles&... titles) {
+        static_assert(sizeof...(Titles) == sizeof...(Columns), "one title per column");
+        out << margin() << escape(Color::Cyan) << "║";
+        int index = 0;
+        ((writeSeparator(out, index++),
+          out << escape(color),
+          writeCell(out, std::string_view(titles), Columns::width, Align::Center)), ...);
+        out << escape(Color::Cyan);
+        fill(out, TRAILING);
+        out << "║\n";
+    }
+
+    // One data row; each value is formatted with its column's settings
+    template <typename... Values>
+    static void row(std::ostream& out, const Values&... values) {
+        static_assert(sizeof...(Values) == sizeof...(Columns), "one value per column");
+        out << margin() << escape(Color::Cyan) << "║";
+        int index = 0;
+        ((writeSeparator(out, index++), writeValue<Columns>(out, values)), ...);
+        out << escape(Color::Cyan);
+        fill(out, TRAILING);
+        out << "║\n";
+    }
+
+private:
+    static void writeSeparator(std::ostream& out, int index) {
+        if (index > 0) {
+            out << escape(Color::Cyan) << "│";
+        }
+    }
+
+    template <typename Col, typename T>
+    static void writeValue(std::ostream& out, const T& value) {
+        char buffer[CELL_BUFFER];
+        out << escape(Col::color);
+        writeCell(out, cellText(value, buffer, Col::precision), Col::width, Col::align);
+    }
+
+    template <typename Col, typename T>
+    static void writeValue(std::ostream& out, const Tinted<T>& tinted) {
+        char buffer[CELL_BUFFER];
+        out << escape(tinted.color);
+        writeCell(out, cellText(tinted.value, buffer, Col::precision), Col::width, Col::align);
+    }
+};
+
+} // namespace Layout
+
+#endif // TABLE_LAYOUT_HPP
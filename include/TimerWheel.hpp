@@ -0,0 +1,58 @@
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Hierarchical timer wheel: 4 levels of 64 slots each. Scheduling, cancelling
+// and expiring a timer are all O(1), so millions of timers stay cheap.
+// Ticks are abstract; the caller decides what a tick means (e.g. one second).
+class TimerWheel {
+public:
+    // Node index in the low 32 bits, generation in the high 32 bits (never 0)
+    using TimerId = std::uint64_t;
+    static constexpr TimerId INVALID_TIMER = 0;
+
+    explicit TimerWheel(std::uint64_t startTick = 0);
+
+    // Schedule a timer; payload is handed back to the callback when it expires
+    TimerId schedule(std::uint64_t expiryTick, std::uint64_t payload);
+
+    // Cancel a pending timer. Returns false if it already fired or was cancelled.
+    bool cancel(TimerId id);
+
+    // Move the wheel forward to nowTick, calling onExpire for every timer that is due
+    void advance(std::uint64_t nowTick, const std::function<void(std::uint64_t)>& onExpire);
+
+    std::uint64_t getCurrentTick() const;
+    std::size_t size() const;
+
+private:
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 6;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+    static constexpr std::uint64_t SLOT_MASK = SLOTS - 1;
+
+    struct Node {
+        std::uint64_t expiry;
+        std::uint64_t payload;
+        std::int32_t prev;
+        std::int32_t next;
+        std::int32_t bucket; // level * SLOTS + slot the node is linked into
+        std::uint32_t generation;
+        bool active;
+    };
+
+    void link(std::int32_t index);
+    void unlink(std::int32_t index);
+    void cascade(int level);
+
+    std::vector<Node> m_nodes;
+    std::vector<std::int32_t> m_freeNodes;
+    std::int32_t m_slots[LEVELS][SLOTS];
+    std::uint64_t m_currentTick;
+    std::size_t m_count;
+};
+
+#endif // TIMER_WHEEL_HPP
@@ -0,0 +1,46 @@
+#ifndef TOP_SELLERS_HPP
+#define TOP_SELLERS_HPP
+
+#include <ctime>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "Money.hpp"
+#include "Receipt.hpp"
+#include "SpaceSaving.hpp"
+
+// Live best sellers and trending items. Sales are streamed into Space-Saving
+// summaries: one for all time and a ring of fixed-length panes for sliding
+// windows (last hour, day, week...). Memory is fixed no matter how long the
+// history is, and a query only merges the panes inside its window.
+class TopSellers {
+public:
+    // Windows can reach back paneSeconds * paneCount; each summary tracks `capacity` items
+    TopSellers(std::size_t capacity = 64, long long paneSeconds = 3600, std::size_t paneCount = 24 * 7);
+
+    void addReceipt(const Receipt& receipt);
+    void record(std::time_t time, int itemId, long long units, Money revenue);
+
+    // Approximate top-k (item ID, total) over the last windowSeconds before now;
+    // windowSeconds <= 0 means all time. Totals may overestimate, never underestimate.
+    std::vector<std::pair<int, long long>> getTopByUnits(std::size_t k, long long windowSeconds, std::time_t now) const;
+    std::vector<std::pair<int, Money>> getTopByRevenue(std::size_t k, long long windowSeconds, std::time_t now) const;
+
+private:
+    struct Pane {
+        long long number = -1; // time / paneSeconds of the pane held in this slot
+        SpaceSaving units;
+        SpaceSaving revenueCents;
+    };
+
+    std::vector<std::pair<int, long long>> getTop(std::size_t k, long long windowSeconds, std::time_t now,
+                                                  bool byRevenue) const;
+
+    long long m_paneSeconds;
+    mutable std::mutex m_mutex;
+    std::vector<Pane> m_panes;
+    SpaceSaving m_allTimeUnits;
+    SpaceSaving m_allTimeRevenueCents;
+};
+
+#endif // TOP_SELLERS_HPP
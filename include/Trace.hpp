@@ -0,0 +1,45 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <chrono>
+#include <string>
+
+// Opt-in timeline tracing. When started, every Span becomes a "complete"
+// event in a Trace Event Format JSON file that chrome://tracing or
+// ui.perfetto.dev can open. Events collect in a buffer owned by the thread
+// that recorded them and are only written out when tracing stops; while
+// tracing is off a Span costs one relaxed atomic load.
+class Trace {
+public:
+    // Environment variable naming the trace file, e.g. ASSET_TRACE=data/trace.json
+    static constexpr const char* ENVIRONMENT_VARIABLE = "ASSET_TRACE";
+
+    // Start recording to filename; the file is written by stop()
+    static void start(const std::string& filename);
+    // Start if ENVIRONMENT_VARIABLE is set; returns whether tracing is on
+    static bool startFromEnvironment();
+    // Write every buffered event and stop recording (also runs at exit)
+    static bool stop();
+    static bool isEnabled();
+
+    // Times a block. Names and categories must be string literals, as only the
+    // pointers are kept until the trace is written.
+    class Span {
+    public:
+        explicit Span(const char* name, const char* category = "app");
+        ~Span();
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+        // End the span before the end of its scope
+        void stop();
+
+    private:
+        const char* m_name;
+        const char* m_category;
+        std::chrono::steady_clock::time_point m_start;
+        bool m_active;
+    };
+};
+
+#endif // TRACE_HPP
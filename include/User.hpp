@@ -1,7 +1,9 @@
 #ifndef USER_HPP
 #define USER_HPP
 
+#include <memory_resource>
 #include <string>
+#include <string_view>
 
 // A class to represent a user in the system
 class User {
@@ -10,21 +12,28 @@ public:
     User();
 
     // Parameterized constructor
-    User(const std::string& username, const std::string& password, bool isAdmin);
+    User(std::string_view username, std::string_view password, bool isAdmin);
 
-    // Getters for user properties
-    std::string getUsername() const;
-    std::string getPassword() const;
+    // The strings always live in the users memory resource, copies included,
+    // so the users row of the memory report covers them
+    User(const User& other);
+    User(User&& other) = default;
+    User& operator=(const User& other) = default;
+    User& operator=(User&& other) = default;
+
+    // Getters for user properties (views, so scans do not copy strings)
+    std::string_view getUsername() const;
+    std::string_view getPassword() const;
     bool isAdmin() const;
 
     // Setters for user properties
-    void setUsername(const std::string& username);
-    void setPassword(const std::string& password);
+    void setUsername(std::string_view username);
+    void setPassword(std::string_view password);
     void setIsAdmin(bool isAdmin);
 
 private:
-    std::string m_username;
-    std::string m_password;
+    std::pmr::string m_username;
+    std::pmr::string m_password;
     bool m_isAdmin;
 };
 
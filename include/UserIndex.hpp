@@ -0,0 +1,48 @@
+#ifndef USER_INDEX_HPP
+#define USER_INDEX_HPP
+
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "MemoryTracker.hpp"
+#include "User.hpp"
+
+// Username -> position in the users vector, so login and registration
+// checks are O(1) instead of a scan. A small Bloom filter sits in front of
+// the hash map and answers most "no such user" lookups without touching it.
+class UserIndex {
+public:
+    static constexpr int NOT_FOUND = -1;
+
+    // Index every user; the first account wins if a username appears twice
+    void rebuild(const std::pmr::vector<User>& users);
+
+    // Record a user that was just appended at the given position
+    void insert(const std::string& username, std::size_t position);
+
+    // Call after users.erase(users.begin() + position): forgets the removed
+    // user and shifts the positions of everyone behind it
+    void erase(const std::string& username, std::size_t position, const std::pmr::vector<User>& users);
+
+    // Position of the user in the vector, or NOT_FOUND
+    int find(const std::string& username) const;
+    bool contains(const std::string& username) const;
+
+    std::size_t size() const;
+
+private:
+    static constexpr int BLOOM_HASHES = 4;
+    static constexpr std::size_t BLOOM_BITS_PER_USER = 16;
+
+    void resizeBloom(std::size_t expectedUsers);
+    void addToBloom(std::uint64_t hash);
+    bool mayContain(std::uint64_t hash) const;
+
+    std::pmr::unordered_map<std::string, std::size_t> m_positions{MemoryTracker::resource(MemoryTracker::Subsystem::Indexes)};
+    std::pmr::vector<std::uint64_t> m_bloom{MemoryTracker::resource(MemoryTracker::Subsystem::Indexes)}; // bit array, size is a power of two words
+    std::size_t m_bloomCapacity = 0;    // users the filter was sized for
+};
+
+#endif // USER_INDEX_HPP
@@ -0,0 +1,29 @@
+#ifndef USER_RECEIPT_INDEX_HPP
+#define USER_RECEIPT_INDEX_HPP
+
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "MemoryTracker.hpp"
+#include "Receipt.hpp"
+#include "StringTable.hpp"
+
+// Per-user posting lists: for every username, the positions of that user's
+// receipts in the receipts vector, oldest first. A purchase history screen
+// reads one list instead of scanning every receipt.
+class UserReceiptIndex {
+public:
+    void rebuild(const std::pmr::vector<Receipt>& receipts);
+    // Record a receipt that was appended at the given position
+    void add(const std::string& username, std::size_t position);
+
+    // Receipt positions of one user (empty if the user has bought nothing)
+    const std::pmr::vector<std::size_t>& getReceipts(const std::string& username) const;
+
+private:
+    // By interned username; the posting lists share the map's resource
+    std::pmr::unordered_map<StringTable::Handle, std::pmr::vector<std::size_t>> m_postings{MemoryTracker::resource(MemoryTracker::Subsystem::Indexes)};
+};
+
+#endif // USER_RECEIPT_INDEX_HPP
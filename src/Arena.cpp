@@ -0,0 +1,23 @@
+#include "../include/Arena.hpp"
+
+Arena::Arena(std::size_t initialBytes, std::pmr::memory_resource* upstream)
+    : m_memory(initialBytes, upstream) {}
+
+void Arena::release() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_memory.release();
+}
+
+// The monotonic resource is not thread-safe on its own
+void* Arena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_memory.allocate(bytes, alignment);
+}
+
+void Arena::do_deallocate(void*, std::size_t, std::size_t) {
+    // Memory comes back all at once in release()
+}
+
+bool Arena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
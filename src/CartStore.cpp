@@ -0,0 +1,158 @@
+#include "../include/CartStore.hpp"
+#include "../include/Durability.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+// Log records, one per line:
+//   A,<stockId>,<quantity>,<username>   add quantity to a cart line
+//   C,<username>                        clear a cart
+// The username goes last so it may contain commas.
+void CartStore::load(const std::string& filename) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_filename = filename;
+    m_carts.clear();
+    m_logRecords = 0;
+
+    fs::path parent = fs::path(filename).parent_path();
+    if (!parent.empty() && !fs::exists(parent)) {
+        fs::create_directories(parent);
+    }
+
+    std::ifstream in(filename);
+    std::string record;
+    while (std::getline(in, record)) {
+        if (record.size() < 2 || record[1] != ',') {
+            continue;
+        }
+        try {
+            if (record[0] == 'A') {
+                std::size_t idEnd = record.find(',', 2);
+                std::size_t qtyEnd = record.find(',', idEnd + 1);
+                if (idEnd == std::string::npos || qtyEnd == std::string::npos) {
+                    continue;
+                }
+                int stockId = std::stoi(record.substr(2, idEnd - 2));
+                int quantity = std::stoi(record.substr(idEnd + 1, qtyEnd - idEnd - 1));
+                applyAdd(StringTable::intern(std::string_view(record).substr(qtyEnd + 1)), stockId, quantity);
+            } else if (record[0] == 'C') {
+                StringTable::Handle user;
+                if (StringTable::lookup(std::string_view(record).substr(2), user)) {
+                    m_carts.erase(user);
+                }
+            }
+            m_logRecords++;
+        } catch (const std::exception& e) {
+            std::cerr << "Skipping malformed record in cart log: " << e.what() << std::endl;
+        }
+    }
+    in.close();
+
+    // Rewrite the log when most of it is history that no longer matters
+    std::size_t liveLines = 0;
+    for (const auto& entry : m_carts) {
+        liveLines += entry.second.size();
+    }
+    if (m_logRecords > 2 * liveLines + 64) {
+        compact();
+    }
+
+    m_log.open(filename, std::ios::app);
+}
+
+std::vector<CartStore::Line> CartStore::getCart(const std::string& username) const {
+    StringTable::Handle user;
+    if (!StringTable::lookup(username, user)) {
+        return std::vector<Line>();
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_carts.find(user);
+    return it == m_carts.end() ? std::vector<Line>() : std::vector<Line>(it->second.begin(), it->second.end());
+}
+
+bool CartStore::isEmpty(const std::string& username) const {
+    StringTable::Handle user;
+    if (!StringTable::lookup(username, user)) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_carts.find(user);
+    return it == m_carts.end() || it->second.empty();
+}
+
+int CartStore::addItem(const std::string& username, int stockId, int quantity) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    StringTable::Handle user = StringTable::intern(username);
+    applyAdd(user, stockId, quantity);
+    append("A," + std::to_string(stockId) + "," + std::to_string(quantity) + "," + username);
+
+    const auto& lines = m_carts[user];
+    auto it = std::find_if(lines.begin(), lines.end(), [stockId](const Line& line) {
+        return line.stockId == stockId;
+    });
+    return it == lines.end() ? 0 : it->quantity;
+}
+
+void CartStore::clear(const std::string& username) {
+    StringTable::Handle user;
+    if (!StringTable::lookup(username, user)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_carts.erase(user) > 0) {
+        append("C," + username);
+    }
+}
+
+std::size_t CartStore::getCartCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_carts.size();
+}
+
+void CartStore::applyAdd(StringTable::Handle user, int stockId, int quantity) {
+    auto& lines = m_carts[user];
+    auto it = std::find_if(lines.begin(), lines.end(), [stockId](const Line& line) {
+        return line.stockId == stockId;
+    });
+    if (it != lines.end()) {
+        it->quantity += quantity;
+    } else {
+        lines.push_back({stockId, quantity});
+    }
+}
+
+// Append one record and flush it, so a crash loses at most the change in flight
+void CartStore::append(const std::string& record) {
+    if (!m_log.is_open()) {
+        return;
+    }
+    m_log << record << '\n';
+    m_log.flush();
+    m_logRecords++;
+}
+
+// Replace the log with one add record per live cart line
+void CartStore::compact() {
+    std::string tempFile = m_filename + ".tmp";
+    {
+        std::ofstream out(tempFile, std::ios::trunc);
+        if (!out.is_open()) {
+            return;
+        }
+        for (const auto& entry : m_carts) {
+            for (const auto& line : entry.second) {
+                out << "A," << line.stockId << "," << line.quantity << "," << StringTable::get(entry.first) << '\n';
+            }
+        }
+    }
+    if (!Durability::replaceFile(tempFile, m_filename)) {
+        std::cerr << "Error compacting cart log" << std::endl;
+        return;
+    }
+    m_logRecords = 0;
+    for (const auto& entry : m_carts) {
+        m_logRecords += entry.second.size();
+    }
+}
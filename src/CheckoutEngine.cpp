@@ -0,0 +1,376 @@
+#include "../include/CheckoutEngine.hpp"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+
+CheckoutEngine::Shard::Shard() : wheel(CheckoutEngine::nowTick()) {}
+
+CheckoutEngine::CheckoutEngine() {}
+
+// Rebuild the per-SKU counters from the catalog
+void CheckoutEngine::load(const std::pmr::vector<Stock>& stocks) {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    m_slots.clear();
+    m_slots.reserve(stocks.size());
+    for (const auto& stock : stocks) {
+        auto slot = std::make_unique<Slot>();
+        slot->word.store(pack(stock.getQuantity(), 0), std::memory_order_relaxed);
+        m_slots[stock.getId()] = std::move(slot);
+    }
+}
+
+void CheckoutEngine::setQuantity(int stockId, int quantity) {
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        Slot* slot = findSlot(stockId);
+        if (slot) {
+            // Replace the on-hand quantity, keep what carts are holding
+            std::uint64_t current = slot->word.load(std::memory_order_acquire);
+            while (!slot->word.compare_exchange_weak(current, pack(quantity, reservedOf(current)),
+                                                     std::memory_order_acq_rel,
+                                                     std::memory_order_acquire)) {
+            }
+            return;
+        }
+    }
+    // New SKU: the map layout changes, so take the exclusive lock
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    auto& slot = m_slots[stockId];
+    if (!slot) {
+        slot = std::make_unique<Slot>();
+    }
+    slot->word.store(pack(quantity, 0), std::memory_order_release);
+}
+
+void CheckoutEngine::removeSku(int stockId) {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    m_slots.erase(stockId);
+}
+
+int CheckoutEngine::getQuantity(int stockId) const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    Slot* slot = findSlot(stockId);
+    return slot ? onHandOf(slot->word.load(std::memory_order_acquire)) : -1;
+}
+
+int CheckoutEngine::getAvailable(int stockId) const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    Slot* slot = findSlot(stockId);
+    if (!slot) {
+        return 0;
+    }
+    std::uint64_t word = slot->word.load(std::memory_order_acquire);
+    return std::max(0, onHandOf(word) - reservedOf(word));
+}
+
+int CheckoutEngine::getReserved(int stockId) const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    Slot* slot = findSlot(stockId);
+    return slot ? reservedOf(slot->word.load(std::memory_order_acquire)) : 0;
+}
+
+int CheckoutEngine::getReservedBy(const std::string& owner, int stockId) {
+    Shard& shard = shardFor(owner);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto owner_it = shard.byOwner.find(owner);
+    if (owner_it == shard.byOwner.end()) {
+        return 0;
+    }
+    for (std::uint32_t index : owner_it->second) {
+        if (shard.reservations[index].stockId == stockId) {
+            return shard.reservations[index].quantity;
+        }
+    }
+    return 0;
+}
+
+bool CheckoutEngine::reserve(const std::string& owner, int stockId, int quantity, int ttlSeconds) {
+    if (quantity <= 0) {
+        return false;
+    }
+    std::shared_lock<std::shared_mutex> mapLock(m_mutex);
+    Slot* slot = findSlot(stockId);
+    if (!slot || !tryReserve(*slot, quantity)) {
+        return false;
+    }
+
+    Shard& shard = shardFor(owner);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    std::uint64_t expiry = nowTick() + static_cast<std::uint64_t>(ttlSeconds);
+    auto& owned = shard.byOwner[owner];
+
+    // Same SKU again: grow the existing hold and restart its TTL
+    for (std::uint32_t index : owned) {
+        Reservation& reservation = shard.reservations[index];
+        if (reservation.stockId == stockId) {
+            reservation.quantity += quantity;
+            shard.wheel.cancel(reservation.timer);
+            reservation.timer = shard.wheel.schedule(expiry, index);
+            return true;
+        }
+    }
+
+    std::uint32_t index;
+    if (!shard.freeReservations.empty()) {
+        index = shard.freeReservations.back();
+        shard.freeReservations.pop_back();
+        shard.reservations[index] = Reservation{owner, stockId, quantity, TimerWheel::INVALID_TIMER};
+    } else {
+        index = static_cast<std::uint32_t>(shard.reservations.size());
+        shard.reservations.push_back(Reservation{owner, stockId, quantity, TimerWheel::INVALID_TIMER});
+    }
+    shard.reservations[index].timer = shard.wheel.schedule(expiry, index);
+    owned.push_back(index);
+    return true;
+}
+
+void CheckoutEngine::releaseAll(const std::string& owner) {
+    std::shared_lock<std::shared_mutex> mapLock(m_mutex);
+    Shard& shard = shardFor(owner);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto owner_it = shard.byOwner.find(owner);
+    if (owner_it == shard.byOwner.end()) {
+        return;
+    }
+    for (std::uint32_t index : owner_it->second) {
+        Reservation& reservation = shard.reservations[index];
+        Slot* slot = findSlot(reservation.stockId);
+        if (slot) {
+            unreserve(*slot, reservation.quantity);
+        }
+        shard.wheel.cancel(reservation.timer);
+        freeReservation(shard, index);
+    }
+    shard.byOwner.erase(owner_it);
+}
+
+void CheckoutEngine::expireReservations() {
+    std::shared_lock<std::shared_mutex> mapLock(m_mutex);
+    for (auto& shard : m_shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        expireShard(shard);
+    }
+}
+
+bool CheckoutEngine::checkout(const std::vector<Line>& lines, std::vector<int>& failedIds) {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+
+    // Lines taken so far, so they can be given back if the cart fails
+    std::vector<std::pair<Slot*, int>> taken;
+    taken.reserve(lines.size());
+
+    for (const auto& line : lines) {
+        Slot* slot = findSlot(line.stockId);
+        if (line.quantity <= 0 || !slot || !tryTake(*slot, line.quantity)) {
+            failedIds.push_back(line.stockId);
+            continue;
+        }
+        taken.emplace_back(slot, line.quantity);
+    }
+
+    if (!failedIds.empty()) {
+        // All or nothing: roll back every line that was taken
+        for (const auto& entry : taken) {
+            entry.first->word.fetch_add(pack(entry.second, 0), std::memory_order_acq_rel);
+        }
+        return false;
+    }
+    return true;
+}
+
+bool CheckoutEngine::checkout(const std::string& owner, const std::vector<Line>& lines, std::vector<int>& failedIds) {
+    std::shared_lock<std::shared_mutex> mapLock(m_mutex);
+    Shard& shard = shardFor(owner);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    expireShard(shard);
+
+    auto owner_it = shard.byOwner.find(owner);
+
+    struct Taken {
+        Slot* slot;
+        int fromReserved;
+        int fromAvailable;
+        std::uint32_t reservation;
+    };
+    std::vector<Taken> taken;
+    taken.reserve(lines.size());
+
+    for (const auto& line : lines) {
+        Slot* slot = findSlot(line.stockId);
+        if (line.quantity <= 0 || !slot) {
+            failedIds.push_back(line.stockId);
+            continue;
+        }
+
+        // Use the owner's hold on this SKU first
+        int fromReserved = 0;
+        std::uint32_t reservationIndex = 0;
+        if (owner_it != shard.byOwner.end()) {
+            for (std::uint32_t index : owner_it->second) {
+                if (shard.reservations[index].stockId == line.stockId) {
+                    // A SKU listed twice must not spend the same hold twice
+                    int held = shard.reservations[index].quantity;
+                    for (const auto& entry : taken) {
+                        if (entry.fromReserved > 0 && entry.reservation == index) {
+                            held -= entry.fromReserved;
+                        }
+                    }
+                    fromReserved = std::min(line.quantity, held);
+                    reservationIndex = index;
+                    break;
+                }
+            }
+        }
+        if (fromReserved > 0 && !tryCommitReserved(*slot, fromReserved)) {
+            failedIds.push_back(line.stockId);
+            continue;
+        }
+
+        int fromAvailable = line.quantity - fromReserved;
+        if (fromAvailable > 0 && !tryTake(*slot, fromAvailable)) {
+            if (fromReserved > 0) {
+                slot->word.fetch_add(pack(fromReserved, fromReserved), std::memory_order_acq_rel);
+            }
+            failedIds.push_back(line.stockId);
+            continue;
+        }
+        taken.push_back({slot, fromReserved, fromAvailable, reservationIndex});
+    }
+
+    if (!failedIds.empty()) {
+        // All or nothing: put stock and holds back exactly as they were
+        for (const auto& entry : taken) {
+            entry.slot->word.fetch_add(pack(entry.fromReserved + entry.fromAvailable, entry.fromReserved),
+                                       std::memory_order_acq_rel);
+        }
+        return false;
+    }
+
+    // The cart went through: shrink or drop the holds that were used
+    for (const auto& entry : taken) {
+        if (entry.fromReserved == 0) {
+            continue;
+        }
+        Reservation& reservation = shard.reservations[entry.reservation];
+        reservation.quantity -= entry.fromReserved;
+        if (reservation.quantity == 0) {
+            shard.wheel.cancel(reservation.timer);
+            auto& owned = owner_it->second;
+            owned.erase(std::find(owned.begin(), owned.end(), entry.reservation));
+            freeReservation(shard, entry.reservation);
+        }
+    }
+    if (owner_it != shard.byOwner.end() && owner_it->second.empty()) {
+        shard.byOwner.erase(owner_it);
+    }
+    return true;
+}
+
+std::uint64_t CheckoutEngine::pack(int onHand, int reserved) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(onHand)) << 32) |
+           static_cast<std::uint32_t>(reserved);
+}
+
+int CheckoutEngine::onHandOf(std::uint64_t word) {
+    return static_cast<int>(static_cast<std::uint32_t>(word >> 32));
+}
+
+int CheckoutEngine::reservedOf(std::uint64_t word) {
+    return static_cast<int>(static_cast<std::uint32_t>(word & 0xffffffffu));
+}
+
+// Reservation ticks are whole seconds of a monotonic clock
+std::uint64_t CheckoutEngine::nowTick() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::seconds>(now).count());
+}
+
+// Buy from the unreserved part of the on-hand quantity
+bool CheckoutEngine::tryTake(Slot& slot, int quantity) {
+    std::uint64_t current = slot.word.load(std::memory_order_acquire);
+    while (onHandOf(current) - reservedOf(current) >= quantity) {
+        std::uint64_t next = pack(onHandOf(current) - quantity, reservedOf(current));
+        if (slot.word.compare_exchange_weak(current, next, std::memory_order_acq_rel,
+                                            std::memory_order_acquire)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Move quantity from available to reserved
+bool CheckoutEngine::tryReserve(Slot& slot, int quantity) {
+    std::uint64_t current = slot.word.load(std::memory_order_acquire);
+    while (onHandOf(current) - reservedOf(current) >= quantity) {
+        std::uint64_t next = pack(onHandOf(current), reservedOf(current) + quantity);
+        if (slot.word.compare_exchange_weak(current, next, std::memory_order_acq_rel,
+                                            std::memory_order_acquire)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Buy quantity that was reserved: it leaves both on-hand and reserved
+bool CheckoutEngine::tryCommitReserved(Slot& slot, int quantity) {
+    std::uint64_t current = slot.word.load(std::memory_order_acquire);
+    while (onHandOf(current) >= quantity && reservedOf(current) >= quantity) {
+        std::uint64_t next = pack(onHandOf(current) - quantity, reservedOf(current) - quantity);
+        if (slot.word.compare_exchange_weak(current, next, std::memory_order_acq_rel,
+                                            std::memory_order_acquire)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void CheckoutEngine::unreserve(Slot& slot, int quantity) {
+    std::uint64_t current = slot.word.load(std::memory_order_acquire);
+    while (true) {
+        int reserved = std::max(0, reservedOf(current) - quantity);
+        if (slot.word.compare_exchange_weak(current, pack(onHandOf(current), reserved),
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_acquire)) {
+            return;
+        }
+    }
+}
+
+// Caller holds m_mutex (shared or exclusive)
+CheckoutEngine::Slot* CheckoutEngine::findSlot(int stockId) const {
+    auto it = m_slots.find(stockId);
+    return it == m_slots.end() ? nullptr : it->second.get();
+}
+
+CheckoutEngine::Shard& CheckoutEngine::shardFor(const std::string& owner) {
+    return m_shards[std::hash<std::string>{}(owner) % SHARD_COUNT];
+}
+
+// Caller holds m_mutex (shared) and the shard mutex
+void CheckoutEngine::expireShard(Shard& shard) {
+    shard.wheel.advance(nowTick(), [&](std::uint64_t payload) {
+        std::uint32_t index = static_cast<std::uint32_t>(payload);
+        Reservation& reservation = shard.reservations[index];
+        Slot* slot = findSlot(reservation.stockId);
+        if (slot) {
+            unreserve(*slot, reservation.quantity);
+        }
+        auto owner_it = shard.byOwner.find(reservation.owner);
+        if (owner_it != shard.byOwner.end()) {
+            auto& owned = owner_it->second;
+            owned.erase(std::remove(owned.begin(), owned.end(), index), owned.end());
+            if (owned.empty()) {
+                shard.byOwner.erase(owner_it);
+            }
+        }
+        freeReservation(shard, index);
+    });
+}
+
+void CheckoutEngine::freeReservation(Shard& shard, std::uint32_t index) {
+    Reservation& reservation = shard.reservations[index];
+    reservation.owner.clear();
+    reservation.quantity = 0;
+    reservation.timer = TimerWheel::INVALID_TIMER;
+    shard.freeReservations.push_back(index);
+}
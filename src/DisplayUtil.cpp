@@ -1,22 +1,55 @@
 #include "../include/DisplayUtil.hpp"
 #include <tabulate/table.hpp>
+#include "../include/TableLayout.hpp"
+#include <algorithm>
+#include <sstream>
+#include <unordered_map>
 using namespace std;
 using namespace tabulate;
-void DisplayUtil::displayStocks(const std::vector<Stock>& stocks) { 
-    // Dynamic centering setup
-    const int tableWidth = 82;     // inside width of box
-    const int terminalWidth = 164; // adjust for your terminal width
-    int leftPadding = (terminalWidth - (tableWidth + 4)) / 2; // +4 for borders
-
-    auto padLeft = [&](const string& text) {
-        return string(leftPadding, ' ') + text;
-    };
-    
-    auto centerText = [&](const string& text) {
-        int spacesLeft = (tableWidth - text.size()) / 2;
-        int spacesRight = tableWidth - text.size() - spacesLeft;
-        return string(spacesLeft, ' ') + text + string(spacesRight, ' ');
+using Layout::padLeft;
+using Layout::centerText;
+
+namespace {
+    // Column widths, alignment and colours are fixed at compile time
+    using CatalogTable = Layout::TableLayout<
+        Layout::Column<6, Layout::Align::Center, Layout::Color::Magenta>,
+        Layout::Column<24, Layout::Align::Left, Layout::Color::Blue>,
+        Layout::Column<11, Layout::Align::Center>,
+        Layout::Column<15, Layout::Align::Center, Layout::Color::Green>>;
+
+    // Formatted catalog rows keyed by stock ID. A row is reused until the
+    // stock's version changes, so redrawing a page is mostly copying bytes.
+    struct CachedRow {
+        std::uint64_t version;
+        std::string text;
     };
+    std::unordered_map<int, CachedRow> rowCache;
+    std::ostringstream rowStream;
+
+    const std::string& catalogRow(const Stock& stock) {
+        CachedRow& cached = rowCache[stock.getId()];
+        if (cached.version == stock.getVersion() && !cached.text.empty()) {
+            return cached.text;
+        }
+
+        // Color coding based on quantity
+        Layout::Color quantityColor = Layout::Color::Green;  // Green for good stock
+        if (stock.getQuantity() < 10) quantityColor = Layout::Color::Yellow; // Yellow for low stock
+        if (stock.getQuantity() < 5) quantityColor = Layout::Color::Red;     // Red for very low stock
+
+        rowStream.str(std::string());
+        CatalogTable::row(rowStream, stock.getId(), stock.getName(),
+                          Layout::tint(stock.getQuantity(), quantityColor), stock.getPrice());
+        cached.version = stock.getVersion();
+        cached.text = rowStream.str();
+        return cached.text;
+    }
+}
+
+int DisplayUtil::displayStocks(const std::pmr::vector<Stock>& stocks, std::size_t first, std::size_t count) {
+    if (count == 0) {
+        count = CATALOG_PAGE_SIZE;
+    }
 
     if (stocks.empty()) {
         // Enhanced "no stocks" message
@@ -32,8 +65,17 @@ void DisplayUtil::displayStocks(const std::vector<Stock>& stocks) {
         cout << padLeft("║") << "\033[95m" << centerText("Please contact admin to add products") << "\033[91m" << "║\n";
         cout << padLeft("║") << centerText("") << "║\n";
         cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\n";
-        return;
+        return 11;
+    }
+
+    // Clamp the window to the catalog
+    if (first >= stocks.size()) {
+        first = ((stocks.size() - 1) / count) * count;
     }
+    std::size_t last = std::min(stocks.size(), first + count);
+    std::size_t pageCount = (stocks.size() + count - 1) / count;
+    string pageText = "Page " + to_string(first / count + 1) + " of " + to_string(pageCount) +
+                      "  (items " + to_string(first + 1) + "-" + to_string(last) + ")";
 
     // Enhanced header with stock count
     cout << "\033[96m\033[1m";
@@ -42,59 +84,42 @@ void DisplayUtil::displayStocks(const std::vector<Stock>& stocks) {
     cout << padLeft("║") << "\033[93m" << centerText("📋 PRODUCT CATALOG - INVENTORY 📋") << "\033[96m" << "    ║\n";
     cout << padLeft("║") << centerText("") << "║\n";
     cout << padLeft("║") << "\033[95m" << centerText("Available Products: " + to_string(stocks.size()) + " items") << "\033[96m" << "║\n";
-    cout << padLeft("║") << centerText("") << "║\n";
+    cout << padLeft("║") << "\033[97m" << centerText(pageText) << "\033[96m" << "║\n";
     cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
     cout << "\033[0m";
 
-    // Enhanced table header with colors
     cout << "\033[96m\033[1m";
-    cout << padLeft("║") << "\033[94m" << "  ID  " << "\033[96m" << "│" << "\033[94m" << "      Product Name      " << "\033[96m" << "│" 
-         << "\033[94m" << " Quantity " << "\033[96m" << " │" << "\033[94m" << "   Price ($)   " << "\033[96m" << "                       ║\n";
+    CatalogTable::header(cout, Layout::Color::Blue, "ID", "Product Name", "Quantity", "Price");
     cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
-    cout << "\033[0m";
 
-    // Display each stock item with enhanced formatting
-    for (const auto& stock : stocks) {
-        cout << "\033[96m\033[1m";
-        
-        // Format ID (center in 5 chars)
-        string id_str = to_string(stock.getId());
-        int id_padding = (5 - id_str.length()) / 2;
-        string formatted_id = string(id_padding, ' ') + id_str + string(5 - id_str.length() - id_padding, ' ');
-        
-        // Format Name (truncate/pad to 22 chars)
-        string name = stock.getName();
-        if (name.length() > 22) {
-            name = name.substr(0, 19) + "...";
-        }
-        string formatted_name = name + string(22 - name.length(), ' ');
-        
-        // Format Quantity (center in 9 chars)
-        string qty_str = to_string(stock.getQuantity());
-        int qty_padding = (9 - qty_str.length()) / 2;
-        string formatted_qty = string(qty_padding, ' ') + qty_str + string(9 - qty_str.length() - qty_padding, ' ');
-        
-        // Format Price (center in 13 chars)
-        string price_str = to_string(stock.getPrice());
-        int price_padding = (13 - price_str.length()) / 2;
-        string formatted_price = string(price_padding, ' ') + price_str + string(13 - price_str.length() - price_padding, ' ');
-        
-        // Color coding based on quantity
-        string qty_color = "\033[92m"; // Green for good stock
-        if (stock.getQuantity() < 10) qty_color = "\033[93m"; // Yellow for low stock
-        if (stock.getQuantity() < 5) qty_color = "\033[91m";  // Red for very low stock
-        
-        cout << padLeft("║") << "\033[95m" << formatted_id << "\033[96m" << " │" 
-             << "\033[94m" << formatted_name << "\033[96m" << "  │" 
-             << qty_color << formatted_qty << "\033[96m" << "  │" 
-             << "\033[92m" << formatted_price << "\033[96m" << "                         ║\n";
+    // Rows of deleted stock linger in the cache; drop them all once they pile up
+    if (rowCache.size() > 2 * stocks.size() + count) {
+        rowCache.clear();
+    }
+
+    // Only the rows of the visible page are drawn, mostly from the row cache
+    for (std::size_t i = first; i < last; ++i) {
+        const string& row = catalogRow(stocks[i]);
+        cout.write(row.data(), static_cast<std::streamsize>(row.size()));
     }
 
     // Table footer with summary
     cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\n";
+    return static_cast<int>(10 + (last - first));
+}
+
+std::size_t DisplayUtil::findStockPage(const std::pmr::vector<Stock>& stocks, int id, std::size_t pageSize) {
+    auto it = std::lower_bound(stocks.begin(), stocks.end(), id, [](const Stock& stock, int value) {
+        return stock.getId() < value;
+    });
+    std::size_t index = static_cast<std::size_t>(it - stocks.begin());
+    if (index >= stocks.size() && !stocks.empty()) {
+        index = stocks.size() - 1;
+    }
+    return (index / pageSize) * pageSize;
 }
 
-void DisplayUtil::displayUsers(const std::vector<User>& users) {
+void DisplayUtil::displayUsers(const std::pmr::vector<User>& users) {
     if (users.empty()) {
         std::cout << "No user accounts found." << std::endl;
         return;
@@ -107,8 +132,8 @@ void DisplayUtil::displayUsers(const std::vector<User>& users) {
     // Add user data to the table
     for (const auto& user : users) {
         users_table.add_row({
-            user.getUsername(),
-            user.getPassword(),
+            std::string(user.getUsername()),
+            std::string(user.getPassword()),
             user.isAdmin() ? "True" : "False"
         });
     }
@@ -0,0 +1,320 @@
+#include "../include/Durability.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct Pending {
+        std::function<bool()> task;
+        Clock::time_point due;
+        int attempts = 0; // failed runs so far
+    };
+
+    struct State {
+        std::mutex mutex;
+        std::condition_variable wake;     // new work, or time to stop
+        std::condition_variable finished; // a batch of tasks has run
+        std::chrono::milliseconds window{0};
+        std::map<std::string, Pending> pending;
+        std::set<std::string> running;
+        std::set<std::string> failed;     // given up on, and not saved since
+        std::deque<std::string> errors;
+        std::thread flusher;
+        bool stopping = false;
+    };
+
+    // Never destroyed: stores in other files cancel their tasks from their own
+    // destructors, which may run after this file's statics are gone
+    State& state() {
+        static State* instance = new State();
+        return *instance;
+    }
+
+    void addError(State& s, std::string message) {
+        if (s.errors.size() >= Durability::MAX_ERRORS) {
+            s.errors.pop_front();
+        }
+        s.errors.push_back(std::move(message));
+    }
+
+    // Run tasks outside the lock, then mark their keys as done and queue failed
+    // ones again. No metrics, trace spans or printing here: this runs on the
+    // flusher thread and from static destruction.
+    void runTasks(std::unique_lock<std::mutex>& lock, std::vector<std::pair<std::string, Pending>>& batch) {
+        State& s = state();
+        lock.unlock();
+        std::vector<bool> saved;
+        saved.reserve(batch.size());
+        for (auto& entry : batch) {
+            saved.push_back(entry.second.task());
+        }
+        lock.lock();
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            const std::string& key = batch[i].first;
+            Pending& pending = batch[i].second;
+            s.running.erase(key);
+            if (saved[i]) {
+                s.failed.erase(key);
+            } else if (s.pending.count(key) > 0) {
+                // A newer save of the same file was queued while this one ran
+            } else if (++pending.attempts < Durability::MAX_ATTEMPTS) {
+                pending.due = Clock::now() + s.window;
+                s.pending.emplace(key, std::move(pending));
+            } else {
+                s.failed.insert(key);
+                addError(s, "Gave up saving " + key + " after " + std::to_string(pending.attempts) + " attempts");
+            }
+        }
+        s.finished.notify_all();
+    }
+
+    // Take the tasks that are due (or all of them) out of the queue
+    std::vector<std::pair<std::string, Pending>> takeTasks(bool all) {
+        State& s = state();
+        std::vector<std::pair<std::string, Pending>> batch;
+        Clock::time_point now = Clock::now();
+        for (auto it = s.pending.begin(); it != s.pending.end();) {
+            if (all || it->second.due <= now) {
+                s.running.insert(it->first);
+                batch.emplace_back(it->first, std::move(it->second));
+                it = s.pending.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        return batch;
+    }
+
+    void flusherLoop() {
+        State& s = state();
+        std::unique_lock<std::mutex> lock(s.mutex);
+        while (!s.stopping) {
+            if (s.pending.empty()) {
+                s.wake.wait(lock);
+                continue;
+            }
+            Clock::time_point due = Clock::time_point::max();
+            for (const auto& entry : s.pending) {
+                due = std::min(due, entry.second.due);
+            }
+            if (Clock::now() < due) {
+                s.wake.wait_until(lock, due);
+                continue;
+            }
+            std::vector<std::pair<std::string, Pending>> batch = takeTasks(false);
+            runTasks(lock, batch);
+        }
+    }
+
+    // Stops the flusher and makes queued saves durable during static destruction
+    struct FlushGuard {
+        ~FlushGuard() {
+            State& s = state();
+            {
+                std::lock_guard<std::mutex> lock(s.mutex);
+                s.stopping = true;
+            }
+            s.wake.notify_all();
+            if (s.flusher.joinable()) {
+                s.flusher.join();
+            }
+            Durability::flush(); // nowhere left to report a failure
+        }
+    } flushGuard;
+}
+
+void Durability::setBatchWindow(std::chrono::milliseconds window) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.window = window;
+}
+
+std::chrono::milliseconds Durability::getBatchWindow() {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.window;
+}
+
+bool Durability::writeFile(const std::string& filename, std::string bytes) {
+    auto contents = std::make_shared<const std::string>(std::move(bytes));
+    return schedule(filename, [filename, contents]() { return writeFileNow(filename, *contents); });
+}
+
+bool Durability::writeFileNow(const std::string& filename, const std::string& bytes) {
+    std::error_code ec;
+    fs::path parent = fs::path(filename).parent_path();
+    if (!parent.empty()) {
+        fs::create_directories(parent, ec);
+    }
+    std::string tempFile = filename + ".tmp";
+    {
+        std::ofstream file(tempFile, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            reportError("Error saving " + filename + ": cannot open " + tempFile);
+            return false;
+        }
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!file.flush()) {
+            reportError("Error saving " + filename + ": cannot write " + tempFile);
+            return false;
+        }
+    }
+    return replaceFile(tempFile, filename);
+}
+
+bool Durability::appendFileNow(const std::string& filename, const std::string& bytes) {
+    {
+        std::ofstream file(filename, std::ios::binary | std::ios::app);
+        if (!file.is_open()) {
+            reportError("Error saving " + filename + ": cannot open it for appending");
+            return false;
+        }
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!file.flush()) {
+            reportError("Error saving " + filename + ": cannot append to it");
+            return false;
+        }
+    }
+    if (!syncFile(filename)) {
+        reportError("Error saving " + filename + ": cannot sync it");
+        return false;
+    }
+    return true;
+}
+
+bool Durability::replaceFile(const std::string& tempFile, const std::string& filename) {
+    if (!syncFile(tempFile)) {
+        reportError("Error saving " + filename + ": cannot sync " + tempFile);
+        return false;
+    }
+    std::error_code ec;
+    fs::rename(tempFile, filename, ec);
+    if (ec) {
+        reportError("Error saving " + filename + ": " + ec.message());
+        return false;
+    }
+    fs::path parent = fs::path(filename).parent_path();
+    if (!syncDirectory(parent.empty() ? std::string(".") : parent.string())) {
+        reportError("Error saving " + filename + ": cannot sync its directory");
+        return false;
+    }
+    return true;
+}
+
+bool Durability::syncFile(const std::string& filename) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    bool synced = FlushFileBuffers(file) != 0;
+    CloseHandle(file);
+    return synced;
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+#endif
+}
+
+// Makes a rename in the directory durable
+bool Durability::syncDirectory(const std::string& directory) {
+#ifdef _WIN32
+    (void)directory; // NTFS journals the rename itself; directories cannot be flushed
+    return true;
+#else
+    int fd = ::open(directory.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+#endif
+}
+
+bool Durability::schedule(const std::string& key, std::function<bool()> task) {
+    State& s = state();
+    std::unique_lock<std::mutex> lock(s.mutex);
+    if (s.window.count() <= 0 || s.stopping) {
+        lock.unlock();
+        return task();
+    }
+    auto it = s.pending.find(key);
+    if (it != s.pending.end()) {
+        it->second.task = std::move(task); // keeps the original deadline
+        it->second.attempts = 0;
+    } else {
+        s.pending.emplace(key, Pending{std::move(task), Clock::now() + s.window});
+    }
+    if (!s.flusher.joinable()) {
+        s.flusher = std::thread(flusherLoop);
+    }
+    s.wake.notify_all();
+    return true;
+}
+
+// Failed tasks come back into the queue, so keep going until it stays empty
+bool Durability::flush() {
+    State& s = state();
+    std::unique_lock<std::mutex> lock(s.mutex);
+    for (;;) {
+        std::vector<std::pair<std::string, Pending>> batch = takeTasks(true);
+        if (!batch.empty()) {
+            runTasks(lock, batch);
+        } else if (s.running.empty()) {
+            break;
+        } else {
+            s.finished.wait(lock);
+        }
+    }
+    return s.failed.empty();
+}
+
+void Durability::cancel(const std::string& key) {
+    State& s = state();
+    std::unique_lock<std::mutex> lock(s.mutex);
+    s.pending.erase(key);
+    s.finished.wait(lock, [&s, &key]() { return s.running.count(key) == 0; });
+    // A run that just failed may have queued itself again
+    s.pending.erase(key);
+    s.failed.erase(key); // its owner deals with what is left
+}
+
+void Durability::reportError(const std::string& message) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    addError(s, message);
+}
+
+std::vector<std::string> Durability::takeErrors() {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    std::vector<std::string> errors(s.errors.begin(), s.errors.end());
+    s.errors.clear();
+    return errors;
+}
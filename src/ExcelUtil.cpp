@@ -1,10 +1,15 @@
 #include "../include/ExcelUtil.hpp"
+#include "../include/Durability.hpp"
+#include "../include/MemoryTracker.hpp"
+#include "../include/Metrics.hpp"
+#include "../include/Trace.hpp"
 #include <iostream>
 #include <filesystem> // For creating directories
 #include <numeric>
 #include <ctime>
 #include <iomanip>
 #include <sstream>
+#include <stdexcept>
 
 namespace fs = std::filesystem;
 
@@ -20,6 +25,16 @@ void ensureDirectoryExists(const std::string& path) {
     }
 }
 
+// Save through a temporary file, so a crash never leaves a half-written workbook.
+// Throws like wb.save() does when the file cannot be put in place.
+void saveWorkbook(xlnt::workbook& wb, const std::string& filename) {
+    std::string tempFile = filename + ".tmp";
+    wb.save(tempFile);
+    if (!Durability::replaceFile(tempFile, filename)) {
+        throw std::runtime_error("could not save " + filename);
+    }
+}
+
 // Helper to create a user Excel file with headers
 void ExcelUtil::createUsersFile(const std::string& filename) {
     ensureDirectoryExists("data");
@@ -28,12 +43,14 @@ void ExcelUtil::createUsersFile(const std::string& filename) {
     ws.cell("A1").value("Username");
     ws.cell("B1").value("Password");
     ws.cell("C1").value("IsAdmin");
-    wb.save(filename);
+    saveWorkbook(wb, filename);
 }
 
 // Reads user data from the users.xlsx file
-std::vector<User> ExcelUtil::readUsersFromFile(const std::string& filename) {
-    std::vector<User> users;
+std::pmr::vector<User> ExcelUtil::readUsersFromFile(const std::string& filename) {
+    Metrics::ScopedTimer timer("excel_read_users");
+    Trace::Span span("excel_read_users", "excel");
+    std::pmr::vector<User> users(MemoryTracker::resource(MemoryTracker::Subsystem::Users));
     ensureDirectoryExists("data");
     if (!fs::exists(filename)) {
         createUsersFile(filename);
@@ -41,16 +58,21 @@ std::vector<User> ExcelUtil::readUsersFromFile(const std::string& filename) {
     }
 
     try {
+        MemoryTracker::WorkingSetProbe excelMemory(MemoryTracker::Subsystem::Excel);
         xlnt::workbook wb;
+        Trace::Span loadSpan("xlsx_load", "excel"); // unzip and parse the sheet XML
         wb.load(filename);
         xlnt::worksheet ws = wb.active_sheet();
+        loadSpan.stop();
+        excelMemory.stop(); // while the workbook is still loaded
+        Trace::Span rowsSpan("convert_rows", "excel");
         for (auto row : ws.rows(false)) {
             if (row[0].to_string() == "Username") continue;
             
             std::string username = row[0].to_string();
             std::string password = row[1].to_string();
             bool isAdmin = row[2].to_string() == "true";
-            users.emplace_back(username, password, isAdmin);
+            users.emplace_back(std::move(username), std::move(password), isAdmin);
         }
     } catch (const xlnt::exception& e) {
         std::cerr << "Error reading users file: " << e.what() << std::endl;
@@ -59,7 +81,10 @@ std::vector<User> ExcelUtil::readUsersFromFile(const std::string& filename) {
 }
 
 // Writes user data to the users.xlsx file
-void ExcelUtil::writeUsersToFile(const std::string& filename, const std::vector<User>& users) {
+void ExcelUtil::writeUsersToFile(const std::string& filename, const std::pmr::vector<User>& users) {
+    Metrics::ScopedTimer timer("excel_write_users");
+    Trace::Span span("excel_write_users", "excel");
+    MemoryTracker::WorkingSetProbe excelMemory(MemoryTracker::Subsystem::Excel);
     ensureDirectoryExists("data");
     xlnt::workbook wb;
     xlnt::worksheet ws = wb.active_sheet();
@@ -68,12 +93,14 @@ void ExcelUtil::writeUsersToFile(const std::string& filename, const std::vector<
     ws.cell("C1").value("IsAdmin");
     int row_num = 2;
     for (const auto& user : users) {
-        ws.cell("A" + std::to_string(row_num)).value(user.getUsername());
-        ws.cell("B" + std::to_string(row_num)).value(user.getPassword());
+        ws.cell("A" + std::to_string(row_num)).value(std::string(user.getUsername()));
+        ws.cell("B" + std::to_string(row_num)).value(std::string(user.getPassword()));
         ws.cell("C" + std::to_string(row_num)).value(user.isAdmin() ? "true" : "false");
         row_num++;
     }
-    wb.save(filename);
+    Trace::Span saveSpan("xlsx_save", "excel"); // write the XML and zip it
+    saveWorkbook(wb, filename);
+    excelMemory.stop(); // while the workbook is still alive
 }
 
 // Helper to create a stock Excel file with headers
@@ -85,12 +112,15 @@ void ExcelUtil::createStockFile(const std::string& filename) {
     ws.cell("B1").value("Name");
     ws.cell("C1").value("Quantity");
     ws.cell("D1").value("Price");
-    wb.save(filename);
+    ws.cell("E1").value("ReorderThreshold");
+    saveWorkbook(wb, filename);
 }
 
 // Reads stock data from the stock.xlsx file
-std::vector<Stock> ExcelUtil::readStockFromFile(const std::string& filename) {
-    std::vector<Stock> stocks;
+std::pmr::vector<Stock> ExcelUtil::readStockFromFile(const std::string& filename) {
+    Metrics::ScopedTimer timer("excel_read_stock");
+    Trace::Span span("excel_read_stock", "excel");
+    std::pmr::vector<Stock> stocks(MemoryTracker::resource(MemoryTracker::Subsystem::Stocks));
     ensureDirectoryExists("data");
     if (!fs::exists(filename)) {
         createStockFile(filename);
@@ -98,18 +128,32 @@ std::vector<Stock> ExcelUtil::readStockFromFile(const std::string& filename) {
     }
 
     try {
+        MemoryTracker::WorkingSetProbe excelMemory(MemoryTracker::Subsystem::Excel);
         xlnt::workbook wb;
+        Trace::Span loadSpan("xlsx_load", "excel"); // unzip and parse the sheet XML
         wb.load(filename);
         xlnt::worksheet ws = wb.active_sheet();
+        loadSpan.stop();
+        excelMemory.stop(); // while the workbook is still loaded
+        Trace::Span rowsSpan("convert_rows", "excel");
         for (auto row : ws.rows(false)) {
-            if (row[0].to_string() == "ID") continue;
+            const std::string idText = row[0].to_string();
+            if (idText == "ID") continue;
 
             try {
-                int id = std::stoi(row[0].to_string());
+                int id = std::stoi(idText);
                 std::string name = row[1].to_string();
                 int quantity = std::stoi(row[2].to_string());
-                double price = std::stod(row[3].to_string());
-                stocks.emplace_back(id, name, quantity, price);
+                Money price;
+                if (!Money::parse(row[3].to_string(), price)) {
+                    throw std::invalid_argument("invalid price '" + row[3].to_string() + "'");
+                }
+                // Files written before reorder thresholds existed have no column E
+                int reorderThreshold = Stock::DEFAULT_REORDER_THRESHOLD;
+                if (row.length() > 4 && !row[4].to_string().empty()) {
+                    reorderThreshold = std::stoi(row[4].to_string());
+                }
+                stocks.emplace_back(id, name, quantity, price, reorderThreshold);
             } catch (const std::exception& e) {
                 std::cerr << "Skipping malformed row in stock file: " << e.what() << std::endl;
             }
@@ -121,7 +165,10 @@ std::vector<Stock> ExcelUtil::readStockFromFile(const std::string& filename) {
 }
 
 // Writes stock data to the stock.xlsx file
-void ExcelUtil::writeStockToFile(const std::string& filename, const std::vector<Stock>& stocks) {
+void ExcelUtil::writeStockToFile(const std::string& filename, const std::pmr::vector<Stock>& stocks) {
+    Metrics::ScopedTimer timer("excel_write_stock");
+    Trace::Span span("excel_write_stock", "excel");
+    MemoryTracker::WorkingSetProbe excelMemory(MemoryTracker::Subsystem::Excel);
     ensureDirectoryExists("data");
     xlnt::workbook wb;
     xlnt::worksheet ws = wb.active_sheet();
@@ -129,19 +176,23 @@ void ExcelUtil::writeStockToFile(const std::string& filename, const std::vector<
     ws.cell("B1").value("Name");
     ws.cell("C1").value("Quantity");
     ws.cell("D1").value("Price");
+    ws.cell("E1").value("ReorderThreshold");
     int row_num = 2;
     for (const auto& stock : stocks) {
         ws.cell("A" + std::to_string(row_num)).value(stock.getId());
         ws.cell("B" + std::to_string(row_num)).value(stock.getName());
         ws.cell("C" + std::to_string(row_num)).value(stock.getQuantity());
-        ws.cell("D" + std::to_string(row_num)).value(stock.getPrice());
+        ws.cell("D" + std::to_string(row_num)).value(stock.getPrice().toDouble());
+        ws.cell("E" + std::to_string(row_num)).value(stock.getReorderThreshold());
         row_num++;
     }
-    wb.save(filename);
+    Trace::Span saveSpan("xlsx_save", "excel"); // write the XML and zip it
+    saveWorkbook(wb, filename);
+    excelMemory.stop(); // while the workbook is still alive
 }
 
 // Function to find the next available stock ID
-int ExcelUtil::getNextStockId(const std::vector<Stock>& stocks) {
+int ExcelUtil::getNextStockId(const std::pmr::vector<Stock>& stocks) {
     if (stocks.empty()) {
         return 1;
     }
@@ -154,6 +205,19 @@ int ExcelUtil::getNextStockId(const std::vector<Stock>& stocks) {
     }
     return maxId + 1;
 }
+// Parse a "YYYY-MM-DD HH:MM:SS" local time written by writeTransactionsToFile (0 if invalid)
+static std::time_t parseTransactionTime(const std::string& text) {
+    std::tm tm{};
+    std::istringstream iss(text);
+    iss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
+    if (iss.fail()) {
+        return 0;
+    }
+    tm.tm_isdst = -1;
+    std::time_t time = std::mktime(&tm);
+    return time == static_cast<std::time_t>(-1) ? 0 : time;
+}
+
 void ExcelUtil::createTransactionsFile(const std::string& filename) {
     ensureDirectoryExists("data");
     xlnt::workbook wb;
@@ -166,11 +230,13 @@ void ExcelUtil::createTransactionsFile(const std::string& filename) {
     ws.cell("F1").value("PricePerUnit");
     ws.cell("G1").value("TotalPrice");
     ws.cell("H1").value("TransactionTime");
-    wb.save(filename);
+    saveWorkbook(wb, filename);
 }
 
-std::vector<Receipt> ExcelUtil::readTransactionsFromFile(const std::string& filename) {
-    std::vector<Receipt> receipts;
+std::pmr::vector<Receipt> ExcelUtil::readTransactionsFromFile(const std::string& filename) {
+    Metrics::ScopedTimer timer("excel_read_transactions");
+    Trace::Span span("excel_read_transactions", "excel");
+    std::pmr::vector<Receipt> receipts(MemoryTracker::resource(MemoryTracker::Subsystem::Receipts));
     ensureDirectoryExists("data");
     if (!fs::exists(filename)) {
         createTransactionsFile(filename);
@@ -178,34 +244,62 @@ std::vector<Receipt> ExcelUtil::readTransactionsFromFile(const std::string& file
     }
 
     try {
+        MemoryTracker::WorkingSetProbe excelMemory(MemoryTracker::Subsystem::Excel);
         xlnt::workbook wb;
+        Trace::Span loadSpan("xlsx_load", "excel"); // unzip and parse the sheet XML
         wb.load(filename);
         xlnt::worksheet ws = wb.active_sheet();
+        loadSpan.stop();
+        excelMemory.stop(); // while the workbook is still loaded
+        Trace::Span rowsSpan("convert_rows", "excel");
+
+        // Rows of one receipt are written next to each other; gather them back into one receipt
+        int currentId = 0;
+        std::string currentUsername;
+        std::time_t currentTime = 0;
+        std::vector<Receipt::Item> currentItems; // reused: each receipt copies its lines into the arena
+        auto flushReceipt = [&]() {
+            if (!currentItems.empty()) {
+                receipts.emplace_back(currentId, currentItems, currentUsername, currentTime);
+                currentItems.clear();
+            }
+        };
+
         for (auto row : ws.rows(false)) {
-            if (row[0].to_string() == "ReceiptID") continue;
+            const std::string idText = row[0].to_string();
+            if (idText == "ReceiptID") continue;
 
             try {
-                int receiptId = std::stoi(row[0].to_string());
-                std::string username = row[1].to_string();
+                int receiptId = std::stoi(idText);
                 int itemId = std::stoi(row[2].to_string());
-                std::string itemName = row[3].to_string();
                 int quantity = std::stoi(row[4].to_string());
-                double pricePerUnit = std::stod(row[5].to_string());
+                Money pricePerUnit;
+                if (!Money::parse(row[5].to_string(), pricePerUnit)) {
+                    throw std::invalid_argument("invalid price '" + row[5].to_string() + "'");
+                }
 
-                Stock purchasedItem(itemId, itemName, 0, pricePerUnit);
-                std::vector<std::pair<Stock, int>> items = {{purchasedItem, quantity}};
-                receipts.emplace_back(receiptId, items, username);
+                if (currentItems.empty() || receiptId != currentId) {
+                    flushReceipt();
+                    currentId = receiptId;
+                    currentUsername = row[1].to_string();
+                    currentTime = parseTransactionTime(row[7].to_string());
+                }
+                currentItems.push_back({itemId, quantity, pricePerUnit, StringTable::intern(row[3].to_string())});
             } catch (const std::exception& e) {
                 std::cerr << "Skipping malformed row in transactions file: " << e.what() << std::endl;
             }
         }
+        flushReceipt();
     } catch (const xlnt::exception& e) {
         std::cerr << "Error reading transactions file: " << e.what() << std::endl;
     }
     return receipts;
 }
 
-void ExcelUtil::writeTransactionsToFile(const std::string& filename, const std::vector<Receipt>& receipts) {
+void ExcelUtil::writeTransactionsToFile(const std::string& filename, const std::pmr::vector<Receipt>& receipts) {
+    Metrics::ScopedTimer timer("excel_write_transactions");
+    Trace::Span span("excel_write_transactions", "excel");
+    MemoryTracker::WorkingSetProbe excelMemory(MemoryTracker::Subsystem::Excel);
     ensureDirectoryExists("data");
     xlnt::workbook wb;
     xlnt::worksheet ws = wb.active_sheet();
@@ -220,17 +314,14 @@ void ExcelUtil::writeTransactionsToFile(const std::string& filename, const std::
 
     int row_num = 2;
     for (const auto& receipt : receipts) {
-        for (const auto& item_pair : receipt.getItems()) {
-            const Stock& stock_item = item_pair.first;
-            int quantity = item_pair.second;
-
+        for (const auto& item : receipt.getItems()) {
             ws.cell("A" + std::to_string(row_num)).value(receipt.getReceiptId());
             ws.cell("B" + std::to_string(row_num)).value(receipt.getUsername());
-            ws.cell("C" + std::to_string(row_num)).value(stock_item.getId());
-            ws.cell("D" + std::to_string(row_num)).value(stock_item.getName());
-            ws.cell("E" + std::to_string(row_num)).value(quantity);
-            ws.cell("F" + std::to_string(row_num)).value(stock_item.getPrice());
-            ws.cell("G" + std::to_string(row_num)).value(stock_item.getPrice() * quantity);
+            ws.cell("C" + std::to_string(row_num)).value(item.itemId);
+            ws.cell("D" + std::to_string(row_num)).value(item.getName());
+            ws.cell("E" + std::to_string(row_num)).value(item.quantity);
+            ws.cell("F" + std::to_string(row_num)).value(item.unitPrice.toDouble());
+            ws.cell("G" + std::to_string(row_num)).value((item.unitPrice * item.quantity).toDouble());
 
             // ✅ Safe localtime_s usage
             std::time_t time = receipt.getTransactionTime();
@@ -246,10 +337,12 @@ void ExcelUtil::writeTransactionsToFile(const std::string& filename, const std::
             row_num++;
         }
     }
-    wb.save(filename);
+    Trace::Span saveSpan("xlsx_save", "excel"); // write the XML and zip it
+    saveWorkbook(wb, filename);
+    excelMemory.stop(); // while the workbook is still alive
 }
 
-int ExcelUtil::getNextReceiptId(const std::vector<Receipt>& receipts) {
+int ExcelUtil::getNextReceiptId(const std::pmr::vector<Receipt>& receipts) {
     if (receipts.empty()) return 1;
     int maxId = 0;
     for (const auto& receipt : receipts) {
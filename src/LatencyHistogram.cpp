@@ -0,0 +1,73 @@
+#include "../include/LatencyHistogram.hpp"
+
+int LatencyHistogram::bucketOf(std::uint64_t micros) {
+    if (micros < static_cast<std::uint64_t>(SUB_BUCKETS)) {
+        return static_cast<int>(micros);
+    }
+    int msb = 63;
+    while ((micros >> msb) == 0) {
+        msb--;
+    }
+    if (msb > MAX_EXPONENT) {
+        return BUCKET_COUNT - 1;
+    }
+    // The top SUB_BUCKET_BITS + 1 bits pick the bucket inside this power of two
+    int sub = static_cast<int>(micros >> (msb - SUB_BUCKET_BITS));
+    return (msb - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + (sub - SUB_BUCKETS);
+}
+
+std::uint64_t LatencyHistogram::valueOf(int bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return static_cast<std::uint64_t>(bucket);
+    }
+    int shift = bucket / SUB_BUCKETS - 1;
+    std::uint64_t sub = static_cast<std::uint64_t>(bucket % SUB_BUCKETS + SUB_BUCKETS);
+    std::uint64_t low = sub << shift;
+    return low + ((std::uint64_t{1} << shift) >> 1);
+}
+
+void LatencyHistogram::record(std::uint64_t micros) {
+    m_buckets[bucketOf(micros)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(micros, std::memory_order_relaxed);
+    std::uint64_t seen = m_max.load(std::memory_order_relaxed);
+    while (micros > seen && !m_max.compare_exchange_weak(seen, micros, std::memory_order_relaxed)) {
+    }
+}
+
+std::uint64_t LatencyHistogram::getCount() const {
+    return m_count.load(std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::getSumMicros() const {
+    return m_sum.load(std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::getMaxMicros() const {
+    return m_max.load(std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::getPercentile(double q) const {
+    // Total from the buckets themselves, so a concurrent record cannot push the rank past the end
+    std::uint64_t total = 0;
+    for (const auto& bucket : m_buckets) {
+        total += bucket.load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+        return 0;
+    }
+    if (q < 0.0) q = 0.0;
+    if (q > 1.0) q = 1.0;
+    std::uint64_t rank = static_cast<std::uint64_t>(q * static_cast<double>(total - 1)) + 1;
+
+    std::uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            std::uint64_t value = valueOf(i);
+            std::uint64_t max = getMaxMicros();
+            return value < max ? value : max;
+        }
+    }
+    return getMaxMicros();
+}
@@ -0,0 +1,171 @@
+#include "../include/MemoryTracker.hpp"
+#include <atomic>
+#include <fstream>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <unistd.h>
+#endif
+
+namespace {
+    // Plain atomics, zero before any static constructor runs
+    struct Counters {
+        std::atomic<std::uint64_t> liveBytes{0};
+        std::atomic<std::uint64_t> peakBytes{0};
+        std::atomic<std::uint64_t> allocations{0};
+        std::atomic<std::uint64_t> frees{0};
+    };
+    Counters counters[MemoryTracker::SUBSYSTEM_COUNT];
+    Counters total;
+
+    void raisePeak(std::atomic<std::uint64_t>& peak, std::uint64_t value) {
+        std::uint64_t seen = peak.load(std::memory_order_relaxed);
+        while (value > seen && !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    void charge(Counters& c, std::uint64_t size) {
+        std::uint64_t live = c.liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+        c.allocations.fetch_add(1, std::memory_order_relaxed);
+        raisePeak(c.peakBytes, live);
+    }
+
+    void credit(Counters& c, std::uint64_t size) {
+        c.liveBytes.fetch_sub(size, std::memory_order_relaxed);
+        c.frees.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    MemoryTracker::Usage snapshot(const Counters& c) {
+        return MemoryTracker::Usage{c.liveBytes.load(std::memory_order_relaxed),
+                                    c.peakBytes.load(std::memory_order_relaxed),
+                                    c.allocations.load(std::memory_order_relaxed),
+                                    c.frees.load(std::memory_order_relaxed)};
+    }
+
+    // Counts what passes through to the default heap
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        void setCounters(Counters* counters) { m_counters = counters; }
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+            void* pointer = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+            charge(*m_counters, bytes);
+            charge(total, bytes);
+            return pointer;
+        }
+
+        void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+            credit(*m_counters, bytes);
+            credit(total, bytes);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+        Counters* m_counters = nullptr;
+    };
+
+    // Never destroyed: containers in other files free into them during their
+    // own static destruction
+    CountingResource* resources() {
+        static CountingResource* instances = []() {
+            CountingResource* created = new CountingResource[MemoryTracker::SUBSYSTEM_COUNT];
+            for (int i = 0; i < MemoryTracker::SUBSYSTEM_COUNT; ++i) {
+                created[i].setCounters(&counters[i]);
+            }
+            return created;
+        }();
+        return instances;
+    }
+}
+
+std::pmr::memory_resource* MemoryTracker::resource(Subsystem subsystem) {
+    return &resources()[static_cast<int>(subsystem)];
+}
+
+const char* MemoryTracker::getName(Subsystem subsystem) {
+    switch (subsystem) {
+        case Subsystem::Users:    return "users";
+        case Subsystem::Stocks:   return "stocks";
+        case Subsystem::Receipts: return "receipts";
+        case Subsystem::Carts:    return "carts";
+        case Subsystem::Indexes:  return "indexes";
+        case Subsystem::Excel:    return "excel";
+        default:                  return "unknown";
+    }
+}
+
+MemoryTracker::Usage MemoryTracker::getUsage(Subsystem subsystem) {
+    return snapshot(counters[static_cast<int>(subsystem)]);
+}
+
+MemoryTracker::Usage MemoryTracker::getTotal() {
+    return snapshot(total);
+}
+
+void MemoryTracker::writePrometheus(std::ostream& out) {
+    struct Gauge {
+        const char* metric;
+        const char* help;
+        std::uint64_t Usage::*field;
+    };
+    const Gauge gauges[] = {
+        {"asset_memory_live_bytes", "Bytes currently held.", &Usage::liveBytes},
+        {"asset_memory_peak_bytes", "Highest bytes held at once.", &Usage::peakBytes},
+        {"asset_memory_allocations_total", "Allocations made (Excel: operations measured).", &Usage::allocations},
+    };
+    for (const Gauge& gauge : gauges) {
+        out << "# HELP " << gauge.metric << ' ' << gauge.help << '\n';
+        out << "# TYPE " << gauge.metric << (gauge.field == &Usage::allocations ? " counter\n" : " gauge\n");
+        for (int i = 0; i < SUBSYSTEM_COUNT; ++i) {
+            Subsystem subsystem = static_cast<Subsystem>(i);
+            out << gauge.metric << "{subsystem=\"" << getName(subsystem) << "\"} "
+                << getUsage(subsystem).*gauge.field << '\n';
+        }
+        out << gauge.metric << "{subsystem=\"total\"} " << getTotal().*gauge.field << '\n';
+    }
+}
+
+std::uint64_t MemoryTracker::getWorkingSet() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS info;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &info, sizeof(info))) {
+        return 0;
+    }
+    return static_cast<std::uint64_t>(info.WorkingSetSize);
+#else
+    // Second field of statm: resident pages
+    std::ifstream statm("/proc/self/statm");
+    std::uint64_t size = 0;
+    std::uint64_t resident = 0;
+    if (!(statm >> size >> resident)) {
+        return 0;
+    }
+    return resident * static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+MemoryTracker::WorkingSetProbe::WorkingSetProbe(Subsystem subsystem)
+    : m_subsystem(subsystem), m_start(getWorkingSet()), m_active(true) {}
+
+MemoryTracker::WorkingSetProbe::~WorkingSetProbe() {
+    stop();
+}
+
+void MemoryTracker::WorkingSetProbe::stop() {
+    if (!m_active) {
+        return;
+    }
+    m_active = false;
+    std::uint64_t now = getWorkingSet();
+    std::uint64_t growth = now > m_start ? now - m_start : 0;
+    Counters& c = counters[static_cast<int>(m_subsystem)];
+    c.liveBytes.store(growth, std::memory_order_relaxed);
+    c.allocations.fetch_add(1, std::memory_order_relaxed);
+    raisePeak(c.peakBytes, growth);
+}
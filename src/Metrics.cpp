@@ -0,0 +1,139 @@
+#include "../include/Metrics.hpp"
+#include "../include/MemoryTracker.hpp"
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+    // Sorted by name so the exported file is stable between dumps
+    std::mutex registryMutex;
+    std::map<std::string, std::unique_ptr<LatencyHistogram>> registry;
+
+    // Background exporter
+    std::mutex exportMutex;
+    std::condition_variable exportWake;
+    std::thread exportThread;
+    bool exportStop = false;
+    std::string exportFile;
+
+    // Stops the exporter during static destruction if nobody else did
+    struct ExportGuard {
+        ~ExportGuard() { Metrics::stopPeriodicExport(); }
+    } exportGuard;
+
+    void writeQuantile(std::ostream& out, const std::string& operation, const char* quantile, std::uint64_t micros) {
+        out << "asset_operation_latency_seconds{operation=\"" << operation << "\",quantile=\"" << quantile
+            << "\"} " << micros / 1e6 << '\n';
+    }
+}
+
+LatencyHistogram& Metrics::histogram(const std::string& operation) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto& slot = registry[operation];
+    if (!slot) {
+        slot = std::make_unique<LatencyHistogram>();
+    }
+    return *slot;
+}
+
+Metrics::ScopedTimer::ScopedTimer(const std::string& operation)
+    : m_histogram(&histogram(operation)), m_start(std::chrono::steady_clock::now()) {}
+
+Metrics::ScopedTimer::ScopedTimer(LatencyHistogram& histogram)
+    : m_histogram(&histogram), m_start(std::chrono::steady_clock::now()) {}
+
+Metrics::ScopedTimer::~ScopedTimer() {
+    stop();
+}
+
+void Metrics::ScopedTimer::stop() {
+    if (!m_histogram) {
+        return;
+    }
+    auto elapsed = std::chrono::steady_clock::now() - m_start;
+    m_histogram->record(static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+    m_histogram = nullptr;
+}
+
+bool Metrics::writePrometheus(const std::string& filename) {
+    fs::path parent = fs::path(filename).parent_path();
+    std::error_code ec;
+    if (!parent.empty()) {
+        fs::create_directories(parent, ec);
+    }
+
+    std::string tempFile = filename + ".tmp";
+    {
+        std::ofstream out(tempFile, std::ios::trunc);
+        if (!out.is_open()) {
+            return false;
+        }
+        out << std::setprecision(9);
+        out << "# HELP asset_operation_latency_seconds Latency of inventory operations.\n";
+        out << "# TYPE asset_operation_latency_seconds summary\n";
+
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const auto& entry : registry) {
+            const std::string& operation = entry.first;
+            const LatencyHistogram& h = *entry.second;
+            writeQuantile(out, operation, "0.5", h.getPercentile(0.5));
+            writeQuantile(out, operation, "0.99", h.getPercentile(0.99));
+            writeQuantile(out, operation, "0.999", h.getPercentile(0.999));
+            out << "asset_operation_latency_seconds_sum{operation=\"" << operation << "\"} "
+                << h.getSumMicros() / 1e6 << '\n';
+            out << "asset_operation_latency_seconds_count{operation=\"" << operation << "\"} "
+                << h.getCount() << '\n';
+        }
+
+        out << "# HELP asset_operation_latency_max_seconds Slowest call of each operation.\n";
+        out << "# TYPE asset_operation_latency_max_seconds gauge\n";
+        for (const auto& entry : registry) {
+            out << "asset_operation_latency_max_seconds{operation=\"" << entry.first << "\"} "
+                << entry.second->getMaxMicros() / 1e6 << '\n';
+        }
+        MemoryTracker::writePrometheus(out);
+        if (!out) {
+            return false;
+        }
+    }
+    fs::rename(tempFile, filename, ec);
+    return !ec;
+}
+
+void Metrics::startPeriodicExport(const std::string& filename, int intervalSeconds) {
+    stopPeriodicExport();
+    std::lock_guard<std::mutex> lock(exportMutex);
+    exportFile = filename;
+    exportStop = false;
+    exportThread = std::thread([filename, intervalSeconds]() {
+        std::unique_lock<std::mutex> wait(exportMutex);
+        while (!exportWake.wait_for(wait, std::chrono::seconds(intervalSeconds), [] { return exportStop; })) {
+            wait.unlock();
+            writePrometheus(filename);
+            wait.lock();
+        }
+    });
+}
+
+void Metrics::stopPeriodicExport() {
+    std::string filename;
+    {
+        std::lock_guard<std::mutex> lock(exportMutex);
+        if (!exportThread.joinable()) {
+            return;
+        }
+        exportStop = true;
+        filename = exportFile;
+    }
+    exportWake.notify_all();
+    exportThread.join();
+    writePrometheus(filename); // final numbers at shutdown
+}
@@ -0,0 +1,100 @@
+#include "../include/Money.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+Money Money::fromDouble(double amount) {
+    return Money(static_cast<std::int64_t>(std::llround(amount * 100.0)));
+}
+
+// Hand-rolled parser: no locale, no allocation and no double rounding for the
+// common "d+.dd" form. Anything else (exponents, long fractions from numeric
+// cells) falls back to strtod and is rounded to the nearest cent.
+bool Money::parse(const std::string& text, Money& out) {
+    std::size_t i = 0;
+    std::size_t n = text.size();
+    while (i < n && text[i] == ' ') i++;
+    while (n > i && text[n - 1] == ' ') n--;
+
+    bool negative = false;
+    if (i < n && (text[i] == '-' || text[i] == '+')) {
+        negative = text[i] == '-';
+        i++;
+    }
+    if (i < n && text[i] == '$') i++;
+
+    std::int64_t whole = 0;
+    std::size_t digits = 0;
+    while (i < n && text[i] >= '0' && text[i] <= '9') {
+        if (whole > (INT64_MAX - 9) / 1000) return false;
+        whole = whole * 10 + (text[i] - '0');
+        i++;
+        digits++;
+    }
+
+    std::int64_t fraction = 0;
+    std::size_t fractionDigits = 0;
+    if (i < n && text[i] == '.') {
+        i++;
+        while (i < n && text[i] >= '0' && text[i] <= '9') {
+            if (fractionDigits < 2) {
+                fraction = fraction * 10 + (text[i] - '0');
+            } else if (fractionDigits == 2 && text[i] >= '5') {
+                fraction++; // round half up on the third decimal
+            }
+            fractionDigits++;
+            i++;
+        }
+    }
+
+    if (i != n) {
+        // Not a plain decimal (e.g. "1.5E+2"); let the C library handle it
+        std::string trimmed = text.substr(0, n);
+        const char* begin = trimmed.c_str();
+        char* end = nullptr;
+        double value = std::strtod(begin, &end);
+        if (end == begin || *end != '\0' || !std::isfinite(value)) {
+            return false;
+        }
+        out = fromDouble(value);
+        return true;
+    }
+    if (digits == 0 && fractionDigits == 0) {
+        return false;
+    }
+
+    if (fractionDigits == 1) {
+        fraction *= 10;
+    }
+    std::int64_t cents = whole * 100 + fraction;
+    out = Money(negative ? -cents : cents);
+    return true;
+}
+
+std::string Money::toString() const {
+    char buffer[FORMAT_SIZE];
+    return std::string(buffer, format(buffer));
+}
+
+std::size_t Money::format(char (&out)[FORMAT_SIZE]) const {
+    // Format into a small stack buffer from the right
+    char buffer[FORMAT_SIZE];
+    char* p = buffer + sizeof(buffer);
+    std::uint64_t value = m_cents < 0 ? 0 - static_cast<std::uint64_t>(m_cents)
+                                      : static_cast<std::uint64_t>(m_cents);
+    *--p = static_cast<char>('0' + value % 10);
+    value /= 10;
+    *--p = static_cast<char>('0' + value % 10);
+    value /= 10;
+    *--p = '.';
+    do {
+        *--p = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    if (m_cents < 0) {
+        *--p = '-';
+    }
+    std::size_t length = static_cast<std::size_t>(buffer + sizeof(buffer) - p);
+    std::memcpy(out, p, length);
+    return length;
+}
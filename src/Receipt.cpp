@@ -1,17 +1,54 @@
 #include "../include/Receipt.hpp"
-#include <numeric>
+#include "../include/Arena.hpp"
+#include "../include/MemoryTracker.hpp"
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+    // Latest name seen for each item ID, updated as receipts are created
+    std::mutex itemNamesMutex;
+    std::unordered_map<int, StringTable::Handle> latestItemNames;
+    const std::string unknownItemName = "Unknown item";
+
+    // Receipts are only ever appended and live until exit, so their item lines
+    // come from one arena instead of a heap block per receipt.
+    // Never destroyed: receipts held by other globals may outlive this file's statics.
+    Arena& receiptArena() {
+        static Arena* arena = new Arena(64 * 1024, MemoryTracker::resource(MemoryTracker::Subsystem::Receipts));
+        return *arena;
+    }
+}
 
 // Constructor for the Receipt class
-// Receipt::Receipt(int receiptId, const std::vector<std::pair<Stock, int>>& items, const std::string& username)
-//     : receiptId_(receiptId), items_(items), username_(username) {
-Receipt::Receipt(int receiptId, const std::vector<std::pair<Stock, int>>& items, const std::string& username)
-    : receiptId_(receiptId), items_(items), username_(username) {
+Receipt::Receipt(int receiptId, const std::vector<Item>& items, const std::string& username)
+    : Receipt(receiptId, items, username,
+              std::chrono::system_clock::to_time_t(std::chrono::system_clock::now())) {
+}
+
+// Constructor for receipts loaded from disk, which keep their original time
+Receipt::Receipt(int receiptId, const std::vector<Item>& items, const std::string& username, std::time_t transactionTime)
+    : receiptId_(receiptId), items_(items.begin(), items.end(), &receiptArena()), transactionTime_(transactionTime),
+      username_(StringTable::intern(username)) {
     // Calculate total price during object creation
     totalPrice_ = calculateTotalPrice();
-    
-    // Set transaction time to the current time
-    auto now = std::chrono::system_clock::now();
-    transactionTime_ = std::chrono::system_clock::to_time_t(now);
+    std::lock_guard<std::mutex> lock(itemNamesMutex);
+    for (const auto& item : items_) {
+        latestItemNames[item.itemId] = item.name;
+    }
+}
+
+const std::string& Receipt::Item::getName() const {
+    return StringTable::get(name);
+}
+
+Receipt::Item Receipt::makeItem(const Stock& stock, int quantity) {
+    return {stock.getId(), quantity, stock.getPrice(), stock.getNameHandle()};
+}
+
+const std::string& Receipt::getLatestItemName(int itemId) {
+    std::lock_guard<std::mutex> lock(itemNamesMutex);
+    auto it = latestItemNames.find(itemId);
+    return it == latestItemNames.end() ? unknownItemName : StringTable::get(it->second);
 }
 
 // Getters for the Receipt class members
@@ -19,11 +56,11 @@ int Receipt::getReceiptId() const {
     return receiptId_;
 }
 
-const std::vector<std::pair<Stock, int>>& Receipt::getItems() const {
+const std::pmr::vector<Receipt::Item>& Receipt::getItems() const {
     return items_;
 }
 
-double Receipt::getTotalPrice() const {
+Money Receipt::getTotalPrice() const {
     return totalPrice_;
 }
 
@@ -31,17 +68,19 @@ std::time_t Receipt::getTransactionTime() const {
     return transactionTime_;
 }
 
-std::string Receipt::getUsername() const { // Implementation for username getter
+const std::string& Receipt::getUsername() const { // Implementation for username getter
+    return StringTable::get(username_);
+}
+
+StringTable::Handle Receipt::getUsernameHandle() const {
     return username_;
 }
 
 // Helper function to calculate the total price of all items in the receipt
-double Receipt::calculateTotalPrice() const {
-    double total = 0.0;
-    for (const auto& item_pair : items_) {
-        const Stock& stock_item = item_pair.first;
-        int quantity = item_pair.second;
-        total += stock_item.getPrice() * quantity;
+Money Receipt::calculateTotalPrice() const {
+    Money total;
+    for (const auto& item : items_) {
+        total += item.unitPrice * item.quantity;
     }
     return total;
 }
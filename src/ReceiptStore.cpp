@@ -0,0 +1,622 @@
+#include "../include/ReceiptStore.hpp"
+#include "../include/Durability.hpp"
+#include "../include/Metrics.hpp"
+#include "../include/Trace.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+    const char MAGIC[4] = {'R', 'C', 'S', '1'};
+
+    std::uint32_t checksum(const unsigned char* data, std::size_t size) {
+        std::uint32_t hash = 2166136261u; // FNV-1a
+        for (std::size_t i = 0; i < size; ++i) {
+            hash = (hash ^ data[i]) * 16777619u;
+        }
+        return hash;
+    }
+
+    std::uint64_t zigzag(std::int64_t value) {
+        return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    }
+
+    std::int64_t unzigzag(std::uint64_t value) {
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+
+    // Item dictionary key: the ID and the interned name of a line
+    std::uint64_t itemKey(const Receipt::Item& item) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(item.itemId)) << 32) | item.name;
+    }
+
+    // Bits needed for the largest value (at least 1)
+    int bitWidth(std::uint64_t maxValue) {
+        int width = 1;
+        while (width < 64 && (maxValue >> width) != 0) {
+            width++;
+        }
+        return width;
+    }
+
+    class Writer {
+    public:
+        void varint(std::uint64_t value) {
+            while (value >= 0x80) {
+                m_bytes.push_back(static_cast<char>(value | 0x80));
+                value >>= 7;
+            }
+            m_bytes.push_back(static_cast<char>(value));
+        }
+
+        void text(const std::string& value) {
+            varint(value.size());
+            m_bytes += value;
+        }
+
+        // Width, byte length, then every value in width bits, lowest bit first
+        void packed(const std::vector<std::uint64_t>& values) {
+            std::uint64_t maxValue = 0;
+            for (std::uint64_t value : values) {
+                maxValue = std::max(maxValue, value);
+            }
+            int width = bitWidth(maxValue);
+            std::size_t length = (values.size() * width + 7) / 8;
+            varint(static_cast<std::uint64_t>(width));
+            varint(length);
+            std::size_t start = m_bytes.size();
+            m_bytes.reserve(start + length);
+            std::uint64_t buffer = 0;
+            int bits = 0;
+            for (std::uint64_t value : values) {
+                for (int done = 0; done < width;) {
+                    int take = std::min(width - done, 8);
+                    buffer |= ((value >> done) & ((std::uint64_t{1} << take) - 1)) << bits;
+                    bits += take;
+                    done += take;
+                    while (bits >= 8) {
+                        m_bytes.push_back(static_cast<char>(buffer & 0xFF));
+                        buffer >>= 8;
+                        bits -= 8;
+                    }
+                }
+            }
+            if (bits > 0) {
+                m_bytes.push_back(static_cast<char>(buffer & 0xFF));
+            }
+        }
+
+        void fixed32(std::uint32_t value) {
+            for (int shift = 0; shift < 32; shift += 8) {
+                m_bytes.push_back(static_cast<char>((value >> shift) & 0xFF));
+            }
+        }
+
+        void raw(const char* data, std::size_t size) { m_bytes.append(data, size); }
+        const std::string& bytes() const { return m_bytes; }
+        std::string take() { return std::move(m_bytes); }
+
+    private:
+        std::string m_bytes;
+    };
+
+    // Bounds-checked reads; any overrun marks the reader as failed
+    class Reader {
+    public:
+        Reader(const unsigned char* data, std::size_t size) : m_pos(data), m_end(data + size) {}
+
+        bool ok() const { return m_ok; }
+        bool atEnd() const { return m_pos == m_end; }
+
+        std::uint64_t varint() {
+            std::uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (m_pos >= m_end) {
+                    m_ok = false;
+                    return 0;
+                }
+                unsigned char byte = *m_pos++;
+                value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) {
+                    return value;
+                }
+            }
+            m_ok = false;
+            return 0;
+        }
+
+        std::string text() {
+            std::uint64_t length = varint();
+            if (!m_ok || length > static_cast<std::uint64_t>(m_end - m_pos)) {
+                m_ok = false;
+                return std::string();
+            }
+            std::string value(reinterpret_cast<const char*>(m_pos), static_cast<std::size_t>(length));
+            m_pos += length;
+            return value;
+        }
+
+        void packed(std::vector<std::uint64_t>& values, std::size_t count) {
+            std::uint64_t width = varint();
+            std::uint64_t length = varint();
+            if (!m_ok || width == 0 || width > 64 || length > static_cast<std::uint64_t>(m_end - m_pos) ||
+                length < (count * width + 7) / 8) {
+                m_ok = false;
+                return;
+            }
+            values.resize(count);
+            const unsigned char* next = m_pos;
+            std::uint64_t buffer = 0;
+            int bits = 0;
+            for (std::size_t n = 0; n < count; ++n) {
+                std::uint64_t value = 0;
+                for (int done = 0; done < static_cast<int>(width);) {
+                    if (bits == 0) {
+                        buffer = *next++;
+                        bits = 8;
+                    }
+                    int take = std::min(static_cast<int>(width) - done, bits);
+                    value |= (buffer & ((std::uint64_t{1} << take) - 1)) << done;
+                    buffer >>= take;
+                    bits -= take;
+                    done += take;
+                }
+                values[n] = value;
+            }
+            m_pos += length;
+        }
+
+        std::uint32_t fixed32() {
+            const unsigned char* data = bytes(4);
+            if (!data) {
+                return 0;
+            }
+            return static_cast<std::uint32_t>(data[0]) | static_cast<std::uint32_t>(data[1]) << 8 |
+                   static_cast<std::uint32_t>(data[2]) << 16 | static_cast<std::uint32_t>(data[3]) << 24;
+        }
+
+        // The next size bytes, or nullptr if the data ends first
+        const unsigned char* bytes(std::uint64_t size) {
+            if (!m_ok || size > static_cast<std::uint64_t>(m_end - m_pos)) {
+                m_ok = false;
+                return nullptr;
+            }
+            const unsigned char* data = m_pos;
+            m_pos += size;
+            return data;
+        }
+
+        bool expect(const char* data, std::size_t size) {
+            if (static_cast<std::size_t>(m_end - m_pos) < size || std::memcmp(m_pos, data, size) != 0) {
+                m_ok = false;
+                return false;
+            }
+            m_pos += size;
+            return true;
+        }
+
+    private:
+        const unsigned char* m_pos;
+        const unsigned char* m_end;
+        bool m_ok = true;
+    };
+
+    // Read-only view of a whole file
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string& filename) {
+#ifdef _WIN32
+            m_file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                 FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (m_file == INVALID_HANDLE_VALUE) {
+                return;
+            }
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) {
+                return;
+            }
+            m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!m_mapping) {
+                return;
+            }
+            m_data = static_cast<const unsigned char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+            m_size = m_data ? static_cast<std::size_t>(size.QuadPart) : 0;
+#else
+            m_fd = ::open(filename.c_str(), O_RDONLY);
+            if (m_fd < 0) {
+                return;
+            }
+            struct stat info;
+            if (fstat(m_fd, &info) != 0 || info.st_size == 0) {
+                return;
+            }
+            void* view = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, m_fd, 0);
+            if (view == MAP_FAILED) {
+                return;
+            }
+            m_data = static_cast<const unsigned char*>(view);
+            m_size = static_cast<std::size_t>(info.st_size);
+#endif
+        }
+
+        ~MappedFile() {
+#ifdef _WIN32
+            if (m_data) {
+                UnmapViewOfFile(m_data);
+            }
+            if (m_mapping) {
+                CloseHandle(m_mapping);
+            }
+            if (m_file != INVALID_HANDLE_VALUE) {
+                CloseHandle(m_file);
+            }
+#else
+            if (m_data) {
+                munmap(const_cast<unsigned char*>(m_data), m_size);
+            }
+            if (m_fd >= 0) {
+                ::close(m_fd);
+            }
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const unsigned char* data() const { return m_data; }
+        std::size_t size() const { return m_size; }
+
+    private:
+#ifdef _WIN32
+        HANDLE m_file = INVALID_HANDLE_VALUE;
+        HANDLE m_mapping = nullptr;
+#else
+        int m_fd = -1;
+#endif
+        const unsigned char* m_data = nullptr;
+        std::size_t m_size = 0;
+    };
+
+    std::string encodeBody(const std::pmr::vector<Receipt>& receipts) {
+        // Dictionaries: codes in order of first appearance
+        std::unordered_map<StringTable::Handle, std::uint64_t> userCodes;
+        std::vector<StringTable::Handle> users;
+        std::unordered_map<std::uint64_t, std::uint64_t> itemCodes; // by itemKey
+        std::vector<const Receipt::Item*> items;
+
+        std::vector<std::uint64_t> userColumn;
+        std::vector<std::uint64_t> itemColumn;
+        std::vector<std::uint64_t> quantityColumn;
+        std::vector<std::uint64_t> priceColumn;
+        userColumn.reserve(receipts.size());
+
+        for (const auto& receipt : receipts) {
+            auto user = userCodes.emplace(receipt.getUsernameHandle(), users.size());
+            if (user.second) {
+                users.push_back(receipt.getUsernameHandle());
+            }
+            userColumn.push_back(user.first->second);
+            for (const auto& item : receipt.getItems()) {
+                auto code = itemCodes.emplace(itemKey(item), items.size());
+                if (code.second) {
+                    items.push_back(&item);
+                }
+                itemColumn.push_back(code.first->second);
+                quantityColumn.push_back(zigzag(item.quantity));
+                priceColumn.push_back(zigzag(item.unitPrice.getCents()));
+            }
+        }
+
+        Writer out;
+        out.raw(MAGIC, sizeof(MAGIC));
+        out.varint(receipts.size());
+        out.varint(itemColumn.size());
+
+        out.varint(users.size());
+        for (StringTable::Handle user : users) {
+            out.text(StringTable::get(user));
+        }
+        out.varint(items.size());
+        for (const Receipt::Item* item : items) {
+            out.varint(zigzag(item->itemId));
+            out.text(item->getName());
+        }
+
+        std::int64_t previousId = 0;
+        for (const auto& receipt : receipts) {
+            out.varint(zigzag(static_cast<std::int64_t>(receipt.getReceiptId()) - previousId));
+            previousId = receipt.getReceiptId();
+        }
+        std::int64_t previousTime = 0;
+        for (const auto& receipt : receipts) {
+            std::int64_t time = static_cast<std::int64_t>(receipt.getTransactionTime());
+            out.varint(zigzag(time - previousTime));
+            previousTime = time;
+        }
+        out.packed(userColumn);
+        for (const auto& receipt : receipts) {
+            out.varint(receipt.getItems().size());
+        }
+        out.packed(itemColumn);
+        out.packed(quantityColumn);
+        out.packed(priceColumn);
+        return out.take();
+    }
+
+    // One appended receipt: payload length, payload, FNV-1a of the payload.
+    // The payload holds the receipt's fields as varints and texts.
+    std::string encodeRecord(const Receipt& receipt) {
+        Writer payload;
+        payload.varint(zigzag(receipt.getReceiptId()));
+        payload.varint(zigzag(static_cast<std::int64_t>(receipt.getTransactionTime())));
+        payload.text(receipt.getUsername());
+        payload.varint(receipt.getItems().size());
+        for (const auto& item : receipt.getItems()) {
+            payload.varint(zigzag(item.itemId));
+            payload.text(item.getName());
+            payload.varint(zigzag(item.quantity));
+            payload.varint(zigzag(item.unitPrice.getCents()));
+        }
+        const std::string& bytes = payload.bytes();
+        Writer frame;
+        frame.varint(bytes.size());
+        frame.raw(bytes.data(), bytes.size());
+        frame.fixed32(checksum(reinterpret_cast<const unsigned char*>(bytes.data()), bytes.size()));
+        return frame.take();
+    }
+
+    // False if the record is cut short or damaged
+    bool readRecord(Reader& in, std::vector<Receipt::Item>& lines, std::pmr::vector<Receipt>& out) {
+        std::uint64_t length = in.varint();
+        const unsigned char* data = in.bytes(length);
+        std::uint32_t sum = in.fixed32();
+        if (!in.ok() || sum != checksum(data, static_cast<std::size_t>(length))) {
+            return false;
+        }
+        Reader payload(data, static_cast<std::size_t>(length));
+        int receiptId = static_cast<int>(unzigzag(payload.varint()));
+        std::time_t time = static_cast<std::time_t>(unzigzag(payload.varint()));
+        std::string username = payload.text();
+        std::uint64_t count = payload.varint();
+        if (!payload.ok() || count > length) {
+            return false;
+        }
+        lines.clear();
+        for (std::uint64_t n = 0; n < count; ++n) {
+            int itemId = static_cast<int>(unzigzag(payload.varint()));
+            StringTable::Handle name = StringTable::intern(payload.text());
+            int quantity = static_cast<int>(unzigzag(payload.varint()));
+            Money price = Money::fromCents(unzigzag(payload.varint()));
+            lines.push_back({itemId, quantity, price, name});
+        }
+        if (!payload.ok() || !payload.atEnd()) {
+            return false;
+        }
+        out.emplace_back(receiptId, lines, username, time);
+        return true;
+    }
+
+    // Writes waiting for their Durability task, per file: a new body (which
+    // replaces the file) and receipts appended after it
+    struct PendingWrite {
+        std::shared_ptr<const std::string> body;
+        std::string tail;
+    };
+
+    struct PendingWrites {
+        std::mutex mutex;
+        std::unordered_map<std::string, PendingWrite> files;
+    };
+
+    // Never destroyed: queued writes run from Durability's exit flush
+    PendingWrites& pendingWrites() {
+        static PendingWrites* instance = new PendingWrites();
+        return *instance;
+    }
+
+    // The task for every write to filename; takes whatever is pending, so a
+    // later write replacing the queued task loses nothing
+    bool writePending(const std::string& filename) {
+        PendingWrites& pending = pendingWrites();
+        PendingWrite work;
+        {
+            std::lock_guard<std::mutex> lock(pending.mutex);
+            auto it = pending.files.find(filename);
+            if (it == pending.files.end()) {
+                return true;
+            }
+            work = std::move(it->second);
+            pending.files.erase(it);
+        }
+        bool written = work.body ? Durability::writeFileNow(filename, *work.body + work.tail)
+                                 : work.tail.empty() || Durability::appendFileNow(filename, work.tail);
+        if (!written) {
+            // Put it back ahead of anything queued since, for the retry; a
+            // newer body already holds every receipt
+            std::lock_guard<std::mutex> lock(pending.mutex);
+            PendingWrite& now = pending.files[filename];
+            if (!now.body) {
+                now.body = std::move(work.body);
+                now.tail = work.tail + now.tail;
+            }
+        }
+        return written;
+    }
+
+    bool queueWrite(const std::string& filename, std::shared_ptr<const std::string> body, const std::string& tail) {
+        {
+            PendingWrites& pending = pendingWrites();
+            std::lock_guard<std::mutex> lock(pending.mutex);
+            PendingWrite& write = pending.files[filename];
+            if (body) {
+                write.body = std::move(body);
+                write.tail.clear();
+            } else {
+                write.tail += tail;
+            }
+        }
+        return Durability::schedule(filename, [filename]() { return writePending(filename); });
+    }
+
+    // Decodes the body and the receipts appended after it. fold is set when
+    // there are appended receipts (or a damaged last one) to write into a new
+    // body, which the caller does once the file is unmapped.
+    bool readStore(const std::string& filename, std::pmr::vector<Receipt>& receipts, bool& fold) {
+        MappedFile file(filename);
+        if (!file.data()) {
+            return false;
+        }
+        Reader in(file.data(), file.size());
+        if (!in.expect(MAGIC, sizeof(MAGIC))) {
+            std::cerr << "Error reading receipt store: " << filename << " is not a receipt store" << std::endl;
+            return false;
+        }
+
+        std::uint64_t receiptCount = in.varint();
+        std::uint64_t lineCount = in.varint();
+        // Every receipt and line takes at least a byte, which bounds both counts
+        if (!in.ok() || receiptCount > file.size() || lineCount > file.size() * 8) {
+            std::cerr << "Error reading receipt store: bad header in " << filename << std::endl;
+            return false;
+        }
+
+        std::vector<std::string> users(static_cast<std::size_t>(std::min<std::uint64_t>(in.varint(), file.size())));
+        for (auto& user : users) {
+            user = in.text();
+        }
+        // ID and name of each dictionary entry; quantity and price come per line
+        std::vector<Receipt::Item> items(static_cast<std::size_t>(std::min<std::uint64_t>(in.varint(), file.size())));
+        for (auto& item : items) {
+            item.itemId = static_cast<int>(unzigzag(in.varint()));
+            item.name = StringTable::intern(in.text());
+        }
+
+        std::size_t count = static_cast<std::size_t>(receiptCount);
+        std::vector<std::int64_t> ids(count);
+        std::vector<std::int64_t> times(count);
+        std::int64_t previous = 0;
+        for (auto& id : ids) {
+            id = previous += unzigzag(in.varint());
+        }
+        previous = 0;
+        for (auto& time : times) {
+            time = previous += unzigzag(in.varint());
+        }
+        std::vector<std::uint64_t> userColumn;
+        in.packed(userColumn, count);
+        std::vector<std::uint64_t> lineCounts(count);
+        std::uint64_t totalLines = 0;
+        for (auto& lines : lineCounts) {
+            lines = in.varint();
+            totalLines += lines;
+        }
+        if (!in.ok() || totalLines != lineCount) {
+            std::cerr << "Error reading receipt store: damaged receipt columns in " << filename << std::endl;
+            return false;
+        }
+        std::vector<std::uint64_t> itemColumn;
+        std::vector<std::uint64_t> quantityColumn;
+        std::vector<std::uint64_t> priceColumn;
+        in.packed(itemColumn, static_cast<std::size_t>(lineCount));
+        in.packed(quantityColumn, static_cast<std::size_t>(lineCount));
+        in.packed(priceColumn, static_cast<std::size_t>(lineCount));
+        if (!in.ok()) {
+            std::cerr << "Error reading receipt store: damaged line columns in " << filename << std::endl;
+            return false;
+        }
+
+        std::pmr::vector<Receipt> loaded(receipts.get_allocator()); // so the move below keeps the memory
+        loaded.reserve(count);
+        std::vector<Receipt::Item> lines; // reused; each receipt copies its lines
+        std::size_t line = 0;
+        for (std::size_t r = 0; r < count; ++r) {
+            if (userColumn[r] >= users.size()) {
+                std::cerr << "Error reading receipt store: bad user code in " << filename << std::endl;
+                return false;
+            }
+            lines.clear();
+            for (std::uint64_t n = 0; n < lineCounts[r]; ++n, ++line) {
+                if (itemColumn[line] >= items.size()) {
+                    std::cerr << "Error reading receipt store: bad item code in " << filename << std::endl;
+                    return false;
+                }
+                const Receipt::Item& item = items[itemColumn[line]];
+                lines.push_back({item.itemId, static_cast<int>(unzigzag(quantityColumn[line])),
+                                 Money::fromCents(unzigzag(priceColumn[line])), item.name});
+            }
+            loaded.emplace_back(static_cast<int>(ids[r]), lines, users[userColumn[r]],
+                                static_cast<std::time_t>(times[r]));
+        }
+
+        std::size_t appended = 0;
+        while (!in.atEnd()) {
+            if (!readRecord(in, lines, loaded)) {
+                // A crash mid-append leaves a short last record; the earlier ones are intact
+                std::cerr << "Error reading receipt store: dropped a damaged receipt at the end of " << filename
+                          << std::endl;
+                fold = true;
+                break;
+            }
+            appended++;
+        }
+        fold = fold || appended > 0;
+        receipts = std::move(loaded);
+        return true;
+    }
+}
+
+bool ReceiptStore::save(const std::string& filename, const std::pmr::vector<Receipt>& receipts) {
+    Metrics::ScopedTimer timer("store_write_receipts");
+    Trace::Span span("store_write_receipts", "store");
+    return queueWrite(filename, std::make_shared<const std::string>(encodeBody(receipts)), std::string());
+}
+
+bool ReceiptStore::append(const std::string& filename, const std::pmr::vector<Receipt>& receipts) {
+    static LatencyHistogram& latency = Metrics::histogram("store_append_receipt");
+    Metrics::ScopedTimer timer(latency);
+    Trace::Span span("store_append_receipt", "store");
+    if (receipts.empty()) {
+        return true;
+    }
+    bool hasBody = false;
+    {
+        PendingWrites& pending = pendingWrites();
+        std::lock_guard<std::mutex> lock(pending.mutex);
+        auto it = pending.files.find(filename);
+        hasBody = it != pending.files.end() && it->second.body;
+    }
+    std::error_code ec;
+    if (!hasBody && !std::filesystem::exists(filename, ec)) {
+        // Nothing to append to yet
+        return queueWrite(filename, std::make_shared<const std::string>(encodeBody(receipts)), std::string());
+    }
+    return queueWrite(filename, nullptr, encodeRecord(receipts.back()));
+}
+
+bool ReceiptStore::load(const std::string& filename, std::pmr::vector<Receipt>& receipts) {
+    Metrics::ScopedTimer timer("store_read_receipts");
+    Trace::Span span("store_read_receipts", "store");
+    bool fold = false;
+    if (!readStore(filename, receipts, fold)) {
+        return false;
+    }
+    if (fold) {
+        save(filename, receipts);
+    }
+    return true;
+}
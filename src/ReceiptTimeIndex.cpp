@@ -0,0 +1,104 @@
+#include "../include/ReceiptTimeIndex.hpp"
+#include <algorithm>
+
+namespace {
+    const long long SECONDS_PER_DAY = 24 * 60 * 60;
+
+    bool entryBefore(const ReceiptTimeIndex::Entry& a, const ReceiptTimeIndex::Entry& b) {
+        return a.time != b.time ? a.time < b.time : a.position < b.position;
+    }
+}
+
+long long ReceiptTimeIndex::dayOf(std::time_t time) {
+    long long t = static_cast<long long>(time);
+    return t >= 0 ? t / SECONDS_PER_DAY : -((-t + SECONDS_PER_DAY - 1) / SECONDS_PER_DAY);
+}
+
+void ReceiptTimeIndex::rebuild(const std::pmr::vector<Receipt>& receipts) {
+    m_entries.clear();
+    m_entries.reserve(receipts.size());
+    for (std::size_t i = 0; i < receipts.size(); ++i) {
+        m_entries.push_back({receipts[i].getTransactionTime(), i});
+    }
+    // The file is normally in time order already; only sort when it is not
+    if (!std::is_sorted(m_entries.begin(), m_entries.end(), entryBefore)) {
+        std::sort(m_entries.begin(), m_entries.end(), entryBefore);
+    }
+    rebuildDayOffsets(0);
+}
+
+void ReceiptTimeIndex::add(const Receipt& receipt, std::size_t position) {
+    Entry entry{receipt.getTransactionTime(), position};
+    if (m_entries.empty() || !entryBefore(entry, m_entries.back())) {
+        // Common case: the new receipt is the latest one
+        m_entries.push_back(entry);
+        long long day = dayOf(entry.time);
+        if (m_days.empty() || m_days.back().day != day) {
+            m_days.push_back({day, m_entries.size() - 1});
+        }
+        return;
+    }
+    auto it = std::upper_bound(m_entries.begin(), m_entries.end(), entry, entryBefore);
+    std::size_t index = static_cast<std::size_t>(it - m_entries.begin());
+    m_entries.insert(it, entry);
+    rebuildDayOffsets(index);
+}
+
+void ReceiptTimeIndex::rebuildDayOffsets(std::size_t fromEntry) {
+    // Keep the offsets of days that end before fromEntry, recompute the rest
+    while (!m_days.empty() && m_days.back().begin >= fromEntry) {
+        m_days.pop_back();
+    }
+    for (std::size_t i = fromEntry; i < m_entries.size(); ++i) {
+        long long day = dayOf(m_entries[i].time);
+        if (m_days.empty() || m_days.back().day != day) {
+            m_days.push_back({day, i});
+        }
+    }
+}
+
+std::size_t ReceiptTimeIndex::lowerBound(std::time_t t) const {
+    // Find the day first, then binary search only inside it
+    long long day = dayOf(t);
+    auto dayIt = std::lower_bound(m_days.begin(), m_days.end(), day, [](const DayOffset& offset, long long d) {
+        return offset.day < d;
+    });
+    if (dayIt == m_days.end()) {
+        return m_entries.size();
+    }
+    if (dayIt->day != day) {
+        return dayIt->begin; // every entry of a later day is >= t
+    }
+    std::size_t end = (dayIt + 1 == m_days.end()) ? m_entries.size() : (dayIt + 1)->begin;
+    auto it = std::lower_bound(m_entries.begin() + dayIt->begin, m_entries.begin() + end, t,
+                               [](const Entry& entry, std::time_t value) { return entry.time < value; });
+    return static_cast<std::size_t>(it - m_entries.begin());
+}
+
+std::pair<const ReceiptTimeIndex::Entry*, const ReceiptTimeIndex::Entry*>
+ReceiptTimeIndex::getRange(std::time_t from, std::time_t to) const {
+    const Entry* base = m_entries.data();
+    if (to <= from || m_entries.empty()) {
+        return {base, base};
+    }
+    return {base + lowerBound(from), base + lowerBound(to)};
+}
+
+std::vector<std::size_t> ReceiptTimeIndex::findRange(std::time_t from, std::time_t to) const {
+    std::vector<std::size_t> positions;
+    auto range = getRange(from, to);
+    positions.reserve(static_cast<std::size_t>(range.second - range.first));
+    for (const Entry* entry = range.first; entry != range.second; ++entry) {
+        positions.push_back(entry->position);
+    }
+    return positions;
+}
+
+std::size_t ReceiptTimeIndex::countInRange(std::time_t from, std::time_t to) const {
+    auto range = getRange(from, to);
+    return static_cast<std::size_t>(range.second - range.first);
+}
+
+const std::pmr::vector<ReceiptTimeIndex::Entry>& ReceiptTimeIndex::getEntries() const {
+    return m_entries;
+}
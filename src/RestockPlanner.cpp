@@ -0,0 +1,109 @@
+#include "../include/RestockPlanner.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const double SECONDS_PER_DAY = 24.0 * 60.0 * 60.0;
+}
+
+RestockPlanner::RestockPlanner(double halfLifeDays, double leadTimeDays, double coverDays)
+    : m_tauDays((halfLifeDays > 0 ? halfLifeDays : 7.0) / std::log(2.0)),
+      m_leadTimeDays(leadTimeDays),
+      m_coverDays(coverDays) {}
+
+void RestockPlanner::rebuild(const std::pmr::vector<Receipt>& receipts) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_slots.clear();
+    m_rate.clear();
+    m_lastDay.clear();
+    for (const auto& receipt : receipts) {
+        double day = static_cast<double>(receipt.getTransactionTime()) / SECONDS_PER_DAY;
+        for (const auto& item : receipt.getItems()) {
+            recordSaleLocked(item.itemId, item.quantity, day);
+        }
+    }
+}
+
+void RestockPlanner::addReceipt(const Receipt& receipt) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    double day = static_cast<double>(receipt.getTransactionTime()) / SECONDS_PER_DAY;
+    for (const auto& item : receipt.getItems()) {
+        recordSaleLocked(item.itemId, item.quantity, day);
+    }
+}
+
+void RestockPlanner::recordSale(int stockId, int units, std::time_t time) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    recordSaleLocked(stockId, units, static_cast<double>(time) / SECONDS_PER_DAY);
+}
+
+// rate(t) = sum over sales of units / tau * exp(-(t - saleTime) / tau),
+// which settles at the true units/day for a steady sales rate
+void RestockPlanner::recordSaleLocked(int stockId, int units, double day) {
+    auto it = m_slots.find(stockId);
+    if (it == m_slots.end()) {
+        m_slots.emplace(stockId, m_rate.size());
+        m_rate.push_back(units / m_tauDays);
+        m_lastDay.push_back(day);
+        return;
+    }
+    std::size_t slot = it->second;
+    if (day >= m_lastDay[slot]) {
+        m_rate[slot] = m_rate[slot] * std::exp(-(day - m_lastDay[slot]) / m_tauDays) + units / m_tauDays;
+        m_lastDay[slot] = day;
+    } else {
+        // A sale older than the last update: add it already decayed
+        m_rate[slot] += units / m_tauDays * std::exp(-(m_lastDay[slot] - day) / m_tauDays);
+    }
+}
+
+std::vector<RestockPlanner::Recommendation> RestockPlanner::plan(const std::pmr::vector<Stock>& stocks,
+                                                                 std::time_t now) const {
+    const std::size_t n = stocks.size();
+    const double nowDay = static_cast<double>(now) / SECONDS_PER_DAY;
+    const double horizon = m_leadTimeDays + m_coverDays;
+
+    // Gather: flat input arrays in catalog order
+    std::vector<double> onHand(n), rate(n), age(n);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (std::size_t i = 0; i < n; ++i) {
+            onHand[i] = stocks[i].getQuantity();
+            auto it = m_slots.find(stocks[i].getId());
+            if (it != m_slots.end()) {
+                rate[i] = m_rate[it->second];
+                age[i] = std::max(0.0, nowDay - m_lastDay[it->second]);
+            } else {
+                rate[i] = 0.0;
+                age[i] = 0.0;
+            }
+        }
+    }
+
+    // Batch kernels: straight loops over contiguous arrays
+    std::vector<double> velocity(n), daysLeft(n), order(n);
+    const double invTau = 1.0 / m_tauDays;
+    for (std::size_t i = 0; i < n; ++i) {
+        velocity[i] = rate[i] * std::exp(-age[i] * invTau);
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        daysLeft[i] = velocity[i] > 1e-9 ? onHand[i] / velocity[i] : -1.0;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        order[i] = std::max(0.0, std::ceil(velocity[i] * horizon - onHand[i]));
+    }
+
+    std::vector<Recommendation> recommendations(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        recommendations[i] = {stocks[i].getId(), velocity[i], daysLeft[i], static_cast<int>(order[i])};
+    }
+    return recommendations;
+}
+
+double RestockPlanner::getLeadTimeDays() const {
+    return m_leadTimeDays;
+}
+
+double RestockPlanner::getCoverDays() const {
+    return m_coverDays;
+}
@@ -0,0 +1,283 @@
+#include "../include/SalesAnalytics.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+
+namespace {
+    // Receipts per worker below which another thread is not worth starting
+    const std::size_t MIN_RECEIPTS_PER_THREAD = 4096;
+
+    // Days since 1970-01-01 of a proleptic Gregorian date (Howard Hinnant's algorithm)
+    long long daysFromCivil(long long y, unsigned m, unsigned d) {
+        y -= m <= 2;
+        const long long era = (y >= 0 ? y : y - 399) / 400;
+        const unsigned yoe = static_cast<unsigned>(y - era * 400);
+        const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+        const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + static_cast<long long>(doe) - 719468;
+    }
+
+    void civilFromDays(long long z, long long& y, unsigned& m, unsigned& d) {
+        z += 719468;
+        const long long era = (z >= 0 ? z : z - 146096) / 146097;
+        const unsigned doe = static_cast<unsigned>(z - era * 146097);
+        const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const unsigned mp = (5 * doy + 2) / 153;
+        d = doy - (153 * mp + 2) / 5 + 1;
+        m = mp < 10 ? mp + 3 : mp - 9;
+        y = static_cast<long long>(yoe) + era * 400 + (m <= 2);
+    }
+
+    long long weekStart(long long day) {
+        // 1970-01-01 was a Thursday; shift so Monday is weekday 0
+        long long weekday = ((day + 3) % 7 + 7) % 7;
+        return day - weekday;
+    }
+}
+
+bool SalesAnalytics::dayNumber(std::time_t time, long long& day, long long& month) {
+    std::tm local{};
+    if (localtime_s(&local, &time) != 0) {
+        return false;
+    }
+    long long year = local.tm_year + 1900;
+    day = daysFromCivil(year, static_cast<unsigned>(local.tm_mon + 1), static_cast<unsigned>(local.tm_mday));
+    month = year * 12 + local.tm_mon;
+    return true;
+}
+
+std::string SalesAnalytics::dayLabel(long long day) {
+    long long y;
+    unsigned m, d;
+    civilFromDays(day, y, m, d);
+    char buf[32]; // room for any long long year
+    std::snprintf(buf, sizeof(buf), "%04lld-%02u-%02u", y, m, d);
+    return buf;
+}
+
+std::string SalesAnalytics::monthLabel(long long month) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%04lld-%02lld", month / 12, month % 12 + 1);
+    return buf;
+}
+
+void SalesAnalytics::Rollup::add(const Receipt& receipt) {
+    long long units = 0;
+    for (const auto& item : receipt.getItems()) {
+        units += item.quantity;
+        unitsByItem[item.itemId] += item.quantity;
+    }
+    Money revenue = receipt.getTotalPrice();
+
+    long long day, month;
+    if (dayNumber(receipt.getTransactionTime(), day, month)) {
+        for (Bucket* bucket : {&byDay[day], &byWeek[weekStart(day)], &byMonth[month]}) {
+            bucket->revenue += revenue;
+            bucket->units += units;
+            bucket->receipts++;
+        }
+    }
+    revenueByUser[receipt.getUsernameHandle()] += revenue;
+    totalRevenue += revenue;
+    totalUnits += units;
+    receiptCount++;
+}
+
+void SalesAnalytics::Rollup::merge(const Rollup& other) {
+    auto mergeBuckets = [](std::map<long long, Bucket>& into, const std::map<long long, Bucket>& from) {
+        for (const auto& entry : from) {
+            Bucket& bucket = into[entry.first];
+            bucket.revenue += entry.second.revenue;
+            bucket.units += entry.second.units;
+            bucket.receipts += entry.second.receipts;
+        }
+    };
+    mergeBuckets(byDay, other.byDay);
+    mergeBuckets(byWeek, other.byWeek);
+    mergeBuckets(byMonth, other.byMonth);
+    for (const auto& entry : other.unitsByItem) {
+        unitsByItem[entry.first] += entry.second;
+    }
+    for (const auto& entry : other.revenueByUser) {
+        revenueByUser[entry.first] += entry.second;
+    }
+    totalRevenue += other.totalRevenue;
+    totalUnits += other.totalUnits;
+    receiptCount += other.receiptCount;
+}
+
+void SalesAnalytics::build(const std::pmr::vector<Receipt>& receipts) {
+    std::size_t threadCount = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    threadCount = std::min(threadCount, receipts.size() / MIN_RECEIPTS_PER_THREAD + 1);
+
+    // Each worker rolls up one contiguous partition; the partials are merged afterwards
+    std::vector<Rollup> partials(threadCount);
+    std::size_t chunk = (receipts.size() + threadCount - 1) / threadCount;
+    auto work = [&](std::size_t part) {
+        std::size_t begin = part * chunk;
+        std::size_t end = std::min(receipts.size(), begin + chunk);
+        for (std::size_t i = begin; i < end; ++i) {
+            partials[part].add(receipts[i]);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t part = 1; part < threadCount; ++part) {
+        workers.emplace_back(work, part);
+    }
+    work(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    for (std::size_t part = 1; part < threadCount; ++part) {
+        partials[0].merge(partials[part]);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_rollup = std::move(partials[0]);
+}
+
+void SalesAnalytics::addReceipt(const Receipt& receipt) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_rollup.add(receipt);
+}
+
+std::vector<SalesAnalytics::Period> SalesAnalytics::lastPeriods(const std::map<long long, Bucket>& buckets,
+                                                                std::size_t count,
+                                                                std::string (*label)(long long)) {
+    std::vector<Period> periods;
+    auto it = buckets.end();
+    while (it != buckets.begin() && periods.size() < count) {
+        --it;
+        periods.push_back({label(it->first), it->second.revenue, it->second.units, it->second.receipts});
+    }
+    std::reverse(periods.begin(), periods.end());
+    return periods;
+}
+
+SalesAnalytics::Period SalesAnalytics::periodOf(const std::map<long long, Bucket>& buckets, long long key,
+                                                std::string label) {
+    Period period;
+    period.label = std::move(label);
+    auto it = buckets.find(key);
+    if (it != buckets.end()) {
+        period.revenue = it->second.revenue;
+        period.units = it->second.units;
+        period.receipts = it->second.receipts;
+    }
+    return period;
+}
+
+std::vector<SalesAnalytics::Period> SalesAnalytics::getDaily(std::size_t count) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return lastPeriods(m_rollup.byDay, count, &SalesAnalytics::dayLabel);
+}
+
+std::vector<SalesAnalytics::Period> SalesAnalytics::getWeekly(std::size_t count) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return lastPeriods(m_rollup.byWeek, count, &SalesAnalytics::dayLabel);
+}
+
+std::vector<SalesAnalytics::Period> SalesAnalytics::getMonthly(std::size_t count) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return lastPeriods(m_rollup.byMonth, count, &SalesAnalytics::monthLabel);
+}
+
+SalesAnalytics::Period SalesAnalytics::getDayOf(std::time_t time) const {
+    long long day, month;
+    if (!dayNumber(time, day, month)) {
+        return Period();
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return periodOf(m_rollup.byDay, day, dayLabel(day));
+}
+
+SalesAnalytics::Period SalesAnalytics::getWeekOf(std::time_t time) const {
+    long long day, month;
+    if (!dayNumber(time, day, month)) {
+        return Period();
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return periodOf(m_rollup.byWeek, weekStart(day), dayLabel(weekStart(day)));
+}
+
+SalesAnalytics::Period SalesAnalytics::getMonthOf(std::time_t time) const {
+    long long day, month;
+    if (!dayNumber(time, day, month)) {
+        return Period();
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return periodOf(m_rollup.byMonth, month, monthLabel(month));
+}
+
+long long SalesAnalytics::getUnitsSold(int itemId) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_rollup.unitsByItem.find(itemId);
+    return it == m_rollup.unitsByItem.end() ? 0 : it->second;
+}
+
+Money SalesAnalytics::getRevenueForUser(const std::string& username) const {
+    StringTable::Handle user;
+    if (!StringTable::lookup(username, user)) {
+        return Money();
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_rollup.revenueByUser.find(user);
+    return it == m_rollup.revenueByUser.end() ? Money() : it->second;
+}
+
+std::vector<std::pair<int, long long>> SalesAnalytics::getTopItemsByUnits(std::size_t count) const {
+    std::vector<std::pair<int, long long>> items;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        items.assign(m_rollup.unitsByItem.begin(), m_rollup.unitsByItem.end());
+    }
+    count = std::min(count, items.size());
+    std::partial_sort(items.begin(), items.begin() + count, items.end(), [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    items.resize(count);
+    return items;
+}
+
+std::vector<std::pair<std::string, Money>> SalesAnalytics::getTopUsersByRevenue(std::size_t count) const {
+    std::vector<std::pair<StringTable::Handle, Money>> users;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        users.assign(m_rollup.revenueByUser.begin(), m_rollup.revenueByUser.end());
+    }
+    count = std::min(count, users.size());
+    std::partial_sort(users.begin(), users.begin() + count, users.end(), [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : StringTable::get(a.first) < StringTable::get(b.first);
+    });
+    std::vector<std::pair<std::string, Money>> top;
+    top.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        top.emplace_back(StringTable::get(users[i].first), users[i].second);
+    }
+    return top;
+}
+
+Money SalesAnalytics::getTotalRevenue() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_rollup.totalRevenue;
+}
+
+long long SalesAnalytics::getReceiptCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_rollup.receiptCount;
+}
+
+double SalesAnalytics::getAverageBasketUnits() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_rollup.receiptCount == 0 ? 0.0
+                                      : static_cast<double>(m_rollup.totalUnits) / m_rollup.receiptCount;
+}
+
+Money SalesAnalytics::getAverageBasketValue() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_rollup.receiptCount == 0 ? Money()
+                                      : Money::fromCents(m_rollup.totalRevenue.getCents() / m_rollup.receiptCount);
+}
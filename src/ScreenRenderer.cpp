@@ -0,0 +1,319 @@
+#include "../include/ScreenRenderer.hpp"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <iostream>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <sys/ioctl.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+
+// Fold the SGR (colour) escapes of text into style. Returns false if text
+// holds any other escape, e.g. a cursor move, which breaks the row model.
+bool applyStyle(const std::string& text, std::string& style) {
+    bool rowsOnly = true;
+    std::size_t pos = text.find('\033');
+    while (pos != std::string::npos) {
+        if (pos + 1 >= text.size() || text[pos + 1] != '[') {
+            rowsOnly = false;
+            pos = text.find('\033', pos + 1);
+            continue;
+        }
+        std::size_t end = pos + 2;
+        while (end < text.size() && (text[end] < 0x40 || text[end] > 0x7E)) {
+            end++;
+        }
+        if (end >= text.size()) {
+            break;
+        }
+        if (text[end] == 'm') {
+            std::string params = text.substr(pos + 2, end - pos - 2);
+            std::string sequence = text.substr(pos, end - pos + 1);
+            if (params.empty() || params == "0") {
+                style.clear();
+            } else if (style.size() < sequence.size() ||
+                       style.compare(style.size() - sequence.size(), sequence.size(), sequence) != 0) {
+                style += sequence;
+            }
+        } else {
+            rowsOnly = false;
+        }
+        pos = text.find('\033', end + 1);
+    }
+    return rowsOnly;
+}
+
+} // namespace
+
+ScreenRenderer& ScreenRenderer::instance() {
+    static ScreenRenderer renderer;
+    return renderer;
+}
+
+ScreenRenderer::~ScreenRenderer() {
+    flush();
+    if (m_original) {
+        std::cout.rdbuf(m_original);
+    }
+}
+
+void ScreenRenderer::install() {
+    ScreenRenderer& renderer = instance();
+    if (renderer.m_original) {
+        return;
+    }
+#ifdef _WIN32
+    // Cursor moves and screen clears are sent as ANSI escapes
+    HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode = 0;
+    if (GetConsoleMode(console, &mode)) {
+        SetConsoleMode(console, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    }
+#endif
+    renderer.m_original = std::cout.rdbuf(&renderer.m_buffer);
+}
+
+void ScreenRenderer::clearScreen() {
+    ScreenRenderer& renderer = instance();
+    if (renderer.m_frameOpen) {
+        // The open frame was never shown, so there is nothing to diff against it
+        renderer.m_pending.resize(renderer.m_frameStart);
+        renderer.m_tracked = std::min(renderer.m_tracked, renderer.m_pending.size());
+        renderer.m_frameOpen = false;
+    }
+    renderer.track();
+
+    renderer.m_frameStyle = renderer.m_style;
+    applyStyle(renderer.m_pending, renderer.m_frameStyle);
+    renderer.m_frameStart = renderer.m_pending.size();
+    renderer.m_frameOpen = true;
+}
+
+void ScreenRenderer::moveCursor(int x, int y) {
+    ScreenRenderer& renderer = instance();
+    if (renderer.m_frameOpen) {
+        renderer.finishFrame();
+    }
+    renderer.track();
+
+    renderer.m_validRows = std::min(renderer.m_validRows, static_cast<std::size_t>(y));
+    renderer.m_cursorRow = static_cast<std::size_t>(y);
+    std::string escape = "\033[" + std::to_string(y + 1) + ";" + std::to_string(x + 1) + "H";
+    renderer.m_pending += escape;
+    renderer.m_tracked = renderer.m_pending.size();
+}
+
+void ScreenRenderer::present() {
+    instance().flush();
+}
+
+int ScreenRenderer::printf(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    va_list sizing;
+    va_copy(sizing, args);
+    int length = std::vsnprintf(nullptr, 0, format, sizing);
+    va_end(sizing);
+    if (length > 0) {
+        std::string text(static_cast<std::size_t>(length) + 1, '\0');
+        std::vsnprintf(&text[0], text.size(), format, args);
+        instance().append(text.data(), static_cast<std::size_t>(length));
+    }
+    va_end(args);
+    return length;
+}
+
+ScreenRenderer::FrameBuffer::int_type ScreenRenderer::FrameBuffer::overflow(int_type ch) {
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        char c = traits_type::to_char_type(ch);
+        instance().append(&c, 1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+std::streamsize ScreenRenderer::FrameBuffer::xsputn(const char* s, std::streamsize count) {
+    instance().append(s, static_cast<std::size_t>(count));
+    return count;
+}
+
+int ScreenRenderer::FrameBuffer::sync() {
+    instance().flush();
+    return 0;
+}
+
+void ScreenRenderer::append(const char* s, std::size_t count) {
+    m_pending.append(s, count);
+}
+
+void ScreenRenderer::flush() {
+    if (m_frameOpen) {
+        finishFrame();
+    }
+    track();
+    // Input may follow any flush and move the cursor down a row
+    m_flushesSinceFrame++;
+    if (m_pending.empty()) {
+        return;
+    }
+    writeOut(m_pending);
+    applyStyle(m_pending, m_style);
+    m_pending.clear();
+    m_frameStart = 0;
+    m_tracked = 0;
+}
+
+void ScreenRenderer::finishFrame() {
+    std::string frame = m_pending.substr(m_frameStart);
+    std::vector<Line> lines;
+    bool diffable = splitLines(frame, m_frameStyle, lines);
+
+    int columns = 0;
+    int rows = 0;
+    if (!terminalSize(columns, rows) || lines.size() >= static_cast<std::size_t>(rows)) {
+        diffable = false; // unknown size, or the frame scrolls the screen
+    }
+    for (std::size_t i = 0; diffable && i < lines.size(); ++i) {
+        if (displayWidth(lines[i].text) > columns) {
+            diffable = false; // a wrapped line takes more than one row
+        }
+    }
+
+    std::string out;
+    if (!diffable || m_previous.empty() || m_validRows == 0) {
+        out = "\033[2J\033[H" + frame;
+    } else {
+        for (std::size_t i = 0; i < lines.size(); ++i) {
+            bool last = i + 1 == lines.size();
+            // The last row is always redrawn so the cursor ends where the frame ends
+            if (!last && i < m_validRows && i < m_previous.size() && m_previous[i] == lines[i]) {
+                continue;
+            }
+            out += "\033[" + std::to_string(i + 1) + ";1H\033[0m" + lines[i].style + lines[i].text;
+            out += last ? "\033[J" : "\033[K";
+        }
+    }
+
+    m_pending.replace(m_frameStart, std::string::npos, out);
+    m_tracked = m_pending.size();
+    m_frameOpen = false;
+    m_previous = diffable ? std::move(lines) : std::vector<Line>();
+    m_validRows = m_previous.size();
+    m_cursorRow = m_previous.empty() ? 0 : m_previous.size() - 1;
+    m_flushesSinceFrame = 0;
+}
+
+// Output written after the frame overwrites rows from the cursor down
+void ScreenRenderer::track() {
+    if (m_frameOpen || m_tracked >= m_pending.size()) {
+        return;
+    }
+    std::string text = m_pending.substr(m_tracked);
+    m_tracked = m_pending.size();
+
+    std::string ignored;
+    if (!applyStyle(text, ignored)) {
+        m_validRows = 0; // cursor moved by an escape we do not follow
+        return;
+    }
+    m_validRows = std::min(m_validRows, m_cursorRow);
+    m_cursorRow += static_cast<std::size_t>(std::count(text.begin(), text.end(), '\n'));
+
+    int columns = 0;
+    int rows = 0;
+    if (!terminalSize(columns, rows) ||
+        m_cursorRow + m_flushesSinceFrame + 1 >= static_cast<std::size_t>(rows)) {
+        m_validRows = 0; // the screen may have scrolled
+    }
+}
+
+bool ScreenRenderer::splitLines(const std::string& frame, const std::string& style, std::vector<Line>& lines) {
+    bool rowsOnly = true;
+    std::string current = style;
+    std::size_t start = 0;
+    while (true) {
+        std::size_t end = frame.find('\n', start);
+        Line line;
+        line.style = current;
+        line.text = frame.substr(start, end == std::string::npos ? std::string::npos : end - start);
+        if (!line.text.empty() && line.text.back() == '\r') {
+            line.text.pop_back();
+        }
+        rowsOnly = applyStyle(line.text, current) && rowsOnly;
+        lines.push_back(std::move(line));
+        if (end == std::string::npos) {
+            break;
+        }
+        start = end + 1;
+    }
+    return rowsOnly;
+}
+
+// Columns a line takes: escapes are skipped, 4-byte UTF-8 (emoji) counts as two
+int ScreenRenderer::displayWidth(const std::string& text) {
+    int width = 0;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c == '\033') {
+            while (i < text.size() && !(text[i] >= 0x40 && text[i] <= 0x7E && text[i] != '[')) {
+                i++;
+            }
+            continue;
+        }
+        if ((c & 0xC0) == 0x80) {
+            continue; // continuation byte
+        }
+        width += (c >= 0xF0) ? 2 : 1;
+    }
+    return width;
+}
+
+bool ScreenRenderer::terminalSize(int& columns, int& rows) {
+#ifdef _WIN32
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (!GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) {
+        return false;
+    }
+    columns = info.srWindow.Right - info.srWindow.Left + 1;
+    rows = info.srWindow.Bottom - info.srWindow.Top + 1;
+#else
+    winsize size{};
+    if (!isatty(STDOUT_FILENO) || ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0) {
+        return false;
+    }
+    columns = size.ws_col;
+    rows = size.ws_row;
+#endif
+    return columns > 0 && rows > 0;
+}
+
+void ScreenRenderer::writeOut(const std::string& bytes) {
+#ifdef _WIN32
+    HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+    const char* data = bytes.data();
+    std::size_t left = bytes.size();
+    while (left > 0) {
+        DWORD written = 0;
+        if (!WriteFile(console, data, static_cast<DWORD>(left), &written, nullptr) || written == 0) {
+            return;
+        }
+        data += written;
+        left -= written;
+    }
+#else
+    const char* data = bytes.data();
+    std::size_t left = bytes.size();
+    while (left > 0) {
+        ssize_t written = ::write(STDOUT_FILENO, data, left);
+        if (written <= 0) {
+            return;
+        }
+        data += written;
+        left -= static_cast<std::size_t>(written);
+    }
+#endif
+}
@@ -0,0 +1,84 @@
+#include "../include/SpaceSaving.hpp"
+#include <utility>
+
+SpaceSaving::SpaceSaving(std::size_t capacity) : m_capacity(capacity == 0 ? 1 : capacity) {
+    m_counters.reserve(m_capacity);
+    m_positions.reserve(m_capacity * 2);
+}
+
+void SpaceSaving::offer(int key, long long weight) {
+    if (weight <= 0) {
+        return;
+    }
+    auto it = m_positions.find(key);
+    if (it != m_positions.end()) {
+        // Counts only grow, so the counter can only move down the min-heap
+        m_counters[it->second].count += weight;
+        siftDown(it->second);
+        return;
+    }
+
+    if (m_counters.size() < m_capacity) {
+        // Room left: add a new leaf and sift it up to keep the heap valid
+        std::size_t index = m_counters.size();
+        m_counters.push_back({key, weight, 0});
+        m_positions[key] = index;
+        while (index > 0) {
+            std::size_t parent = (index - 1) / 2;
+            if (m_counters[parent].count <= m_counters[index].count) {
+                break;
+            }
+            swapCounters(parent, index);
+            index = parent;
+        }
+        return;
+    }
+
+    // Full: take over the smallest counter
+    Counter& smallest = m_counters[0];
+    m_positions.erase(smallest.key);
+    smallest.error = smallest.count;
+    smallest.count += weight;
+    smallest.key = key;
+    m_positions[key] = 0;
+    siftDown(0);
+}
+
+void SpaceSaving::clear() {
+    m_counters.clear();
+    m_positions.clear();
+}
+
+const std::vector<SpaceSaving::Counter>& SpaceSaving::getCounters() const {
+    return m_counters;
+}
+
+std::size_t SpaceSaving::getCapacity() const {
+    return m_capacity;
+}
+
+void SpaceSaving::siftDown(std::size_t index) {
+    std::size_t size = m_counters.size();
+    while (true) {
+        std::size_t left = index * 2 + 1;
+        std::size_t right = left + 1;
+        std::size_t smallest = index;
+        if (left < size && m_counters[left].count < m_counters[smallest].count) {
+            smallest = left;
+        }
+        if (right < size && m_counters[right].count < m_counters[smallest].count) {
+            smallest = right;
+        }
+        if (smallest == index) {
+            return;
+        }
+        swapCounters(index, smallest);
+        index = smallest;
+    }
+}
+
+void SpaceSaving::swapCounters(std::size_t a, std::size_t b) {
+    std::swap(m_counters[a], m_counters[b]);
+    m_positions[m_counters[a].key] = a;
+    m_positions[m_counters[b].key] = b;
+}
@@ -1,18 +1,30 @@
 #include "../include/Stock.hpp"
+#include <atomic>
+
+namespace {
+    // Shared by every Stock, so two records never carry the same version
+    std::atomic<std::uint64_t> nextVersion{1};
+}
 
 // Default constructor implementation
-Stock::Stock() : m_id(0), m_name(""), m_quantity(0), m_price(0.0) {}
+Stock::Stock() : m_id(0), m_name(StringTable::EMPTY), m_quantity(0), m_price(), m_reorderThreshold(DEFAULT_REORDER_THRESHOLD),
+                 m_version(nextVersion++) {}
 
 // Parameterized constructor implementation
-Stock::Stock(int id, const std::string& name, int quantity, double price)
-    : m_id(id), m_name(name), m_quantity(quantity), m_price(price) {}
+Stock::Stock(int id, const std::string& name, int quantity, Money price, int reorderThreshold)
+    : m_id(id), m_name(StringTable::intern(name)), m_quantity(quantity), m_price(price), m_reorderThreshold(reorderThreshold),
+      m_version(nextVersion++) {}
 
 // Getter implementations
 int Stock::getId() const {
     return m_id;
 }
 
-std::string Stock::getName() const {
+const std::string& Stock::getName() const {
+    return StringTable::get(m_name);
+}
+
+StringTable::Handle Stock::getNameHandle() const {
     return m_name;
 }
 
@@ -20,23 +32,40 @@ int Stock::getQuantity() const {
     return m_quantity;
 }
 
-double Stock::getPrice() const {
+Money Stock::getPrice() const {
     return m_price;
 }
 
+int Stock::getReorderThreshold() const {
+    return m_reorderThreshold;
+}
+
+std::uint64_t Stock::getVersion() const {
+    return m_version;
+}
+
 // Setter implementations
 void Stock::setId(int id) {
     m_id = id;
+    m_version = nextVersion++;
 }
 
 void Stock::setName(const std::string& name) {
-    m_name = name;
+    m_name = StringTable::intern(name);
+    m_version = nextVersion++;
 }
 
 void Stock::setQuantity(int quantity) {
     m_quantity = quantity;
+    m_version = nextVersion++;
 }
 
-void Stock::setPrice(double price) {
+void Stock::setPrice(Money price) {
     m_price = price;
+    m_version = nextVersion++;
+}
+
+void Stock::setReorderThreshold(int reorderThreshold) {
+    m_reorderThreshold = reorderThreshold;
+    m_version = nextVersion++;
 }
@@ -0,0 +1,100 @@
+#include "../include/StockAlerts.hpp"
+#include <ctime>
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+void StockAlerts::open(const std::string& logFile, const std::pmr::vector<Stock>& stocks) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    fs::path parent = fs::path(logFile).parent_path();
+    if (!parent.empty() && !fs::exists(parent)) {
+        fs::create_directories(parent);
+    }
+    m_log.open(logFile, std::ios::app);
+
+    // One pass at startup; from here on the set is maintained by the events
+    m_lowStock.clear();
+    for (const auto& stock : stocks) {
+        if (stock.getQuantity() < stock.getReorderThreshold()) {
+            m_lowStock.insert(stock.getId());
+        }
+    }
+}
+
+void StockAlerts::onAdded(const Stock& stock) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // A new item has no history: treat it as coming from "not low"
+    evaluate(stock, false, stock.getReorderThreshold());
+}
+
+void StockAlerts::onQuantityChange(const Stock& stock, int oldQuantity) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    evaluate(stock, oldQuantity < stock.getReorderThreshold(), oldQuantity);
+}
+
+void StockAlerts::onThresholdChange(const Stock& stock, int oldThreshold) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    evaluate(stock, stock.getQuantity() < oldThreshold, stock.getQuantity());
+}
+
+void StockAlerts::onRemoved(int stockId) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_lowStock.erase(stockId);
+}
+
+// Raise an alert only when the item crosses its threshold (or runs out)
+void StockAlerts::evaluate(const Stock& stock, bool wasLow, int oldQuantity) {
+    bool isLow = stock.getQuantity() < stock.getReorderThreshold();
+    if (isLow) {
+        m_lowStock.insert(stock.getId());
+    } else {
+        m_lowStock.erase(stock.getId());
+    }
+
+    if (stock.getQuantity() == 0 && oldQuantity > 0) {
+        raise("OUT_OF_STOCK", stock);
+    } else if (isLow && !wasLow) {
+        raise("LOW_STOCK", stock);
+    } else if (!isLow && wasLow) {
+        raise("RESTOCKED", stock);
+    }
+}
+
+// Alert line: time,kind,id,quantity,threshold,name
+void StockAlerts::raise(const std::string& kind, const Stock& stock) {
+    std::time_t now = std::time(nullptr);
+    std::tm ptm{};
+    std::ostringstream line;
+    if (localtime_s(&ptm, &now) == 0) {
+        line << std::put_time(&ptm, "%Y-%m-%d %H:%M:%S");
+    }
+    line << "," << kind << "," << stock.getId() << "," << stock.getQuantity() << ","
+         << stock.getReorderThreshold() << "," << stock.getName();
+
+    if (m_log.is_open()) {
+        m_log << line.str() << '\n';
+        m_log.flush();
+    }
+    m_recent.push_back(line.str());
+    if (m_recent.size() > RECENT_ALERTS) {
+        m_recent.pop_front();
+    }
+}
+
+std::vector<int> StockAlerts::getLowStockIds() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::vector<int>(m_lowStock.begin(), m_lowStock.end());
+}
+
+std::size_t StockAlerts::getLowStockCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lowStock.size();
+}
+
+std::vector<std::string> StockAlerts::getRecentAlerts(std::size_t count) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::size_t first = m_recent.size() > count ? m_recent.size() - count : 0;
+    return std::vector<std::string>(m_recent.begin() + first, m_recent.end());
+}
@@ -0,0 +1,767 @@
+#include "../include/StockDb.hpp"
+#include "../include/Durability.hpp"
+#include "../include/Metrics.hpp"
+#include "../include/Trace.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+
+#ifdef _WIN32
+    #include <io.h>
+#else
+    #include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// Page layout (all integers little-endian):
+//   meta (pages 0 and 1)  "SDB1", txn u64, root u32, page count u32, height u32,
+//                         record count u64, checksum u32
+//   leaf                  type 1, count u16, then per record: id i32, quantity i32,
+//                         price cents i64, reorder threshold i32, name length u16, name
+//   internal              type 2, count u16, child u32, then per key: key i32, child u32
+// Keys in the subtree of child i + 1 are >= key i.
+namespace {
+    const char MAGIC[4] = {'S', 'D', 'B', '1'};
+    const unsigned char LEAF = 1;
+    const unsigned char INTERNAL = 2;
+    const std::size_t NODE_HEADER = 3;
+    const std::size_t LEAF_ENTRY = 22;
+    const std::size_t INTERNAL_ENTRY = 8;
+    const std::size_t META_BODY = 36;
+
+    void put16(std::string& out, std::uint16_t value) {
+        out.push_back(static_cast<char>(value & 0xFF));
+        out.push_back(static_cast<char>(value >> 8));
+    }
+
+    void put32(std::string& out, std::uint32_t value) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            out.push_back(static_cast<char>((value >> shift) & 0xFF));
+        }
+    }
+
+    void put64(std::string& out, std::uint64_t value) {
+        for (int shift = 0; shift < 64; shift += 8) {
+            out.push_back(static_cast<char>((value >> shift) & 0xFF));
+        }
+    }
+
+    std::uint64_t getBytes(const std::string& in, std::size_t pos, int count) {
+        std::uint64_t value = 0;
+        for (int i = 0; i < count; ++i) {
+            value |= static_cast<std::uint64_t>(static_cast<unsigned char>(in[pos + i])) << (8 * i);
+        }
+        return value;
+    }
+
+    std::uint32_t checksum(const std::string& bytes, std::size_t length) {
+        std::uint32_t hash = 2166136261u; // FNV-1a
+        for (std::size_t i = 0; i < length; ++i) {
+            hash = (hash ^ static_cast<unsigned char>(bytes[i])) * 16777619u;
+        }
+        return hash;
+    }
+}
+
+StockDb::~StockDb() {
+    close();
+}
+
+bool StockDb::open(const std::string& filename) {
+    close();
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::error_code ec;
+    fs::path parent = fs::path(filename).parent_path();
+    if (!parent.empty()) {
+        fs::create_directories(parent, ec);
+    }
+    bool exists = fs::exists(filename, ec);
+    m_file = std::fopen(filename.c_str(), exists ? "r+b" : "w+b");
+    if (!m_file) {
+        std::cerr << "Error opening stock catalog " << filename << std::endl;
+        return false;
+    }
+    m_filename = filename;
+
+    Meta first;
+    Meta second;
+    bool firstValid = readMeta(0, first);
+    bool secondValid = readMeta(1, second);
+    if (!firstValid && !secondValid) {
+        if (exists && fs::file_size(filename, ec) > 0) {
+            std::cerr << "Error opening stock catalog " << filename << ": not a catalog file" << std::endl;
+            closeFile();
+            return false;
+        }
+        m_meta = Meta();
+        m_working = m_meta;
+        if (!commit() || !Durability::syncDirectory(parent.empty() ? std::string(".") : parent.string())) {
+            closeFile();
+            return false;
+        }
+    } else if (firstValid && (!secondValid || first.txn >= second.txn)) {
+        m_meta = first;
+    } else {
+        m_meta = second;
+    }
+    m_working = m_meta;
+
+    // Pages left behind by earlier sessions are whatever the tree does not use
+    std::vector<bool> reachable(m_meta.pageCount, false);
+    if (m_meta.root != NO_PAGE) {
+        markReachable(m_meta.root, 1, reachable);
+    }
+    for (PageId page = 2; page < m_meta.pageCount; ++page) {
+        if (!reachable[page]) {
+            m_free.push_back(page);
+        }
+    }
+    return true;
+}
+
+void StockDb::close() {
+    std::string filename;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        filename = m_filename;
+    }
+    if (!filename.empty()) {
+        Durability::cancel(filename); // outside the lock: a running commit needs it
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_pending && !commit()) {
+        std::cerr << "Error closing stock catalog " << filename << ": the last changes were not saved" << std::endl;
+    }
+    closeFile();
+}
+
+bool StockDb::isOpen() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_file != nullptr;
+}
+
+void StockDb::closeFile() {
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+    m_filename.clear();
+    m_pending = false;
+    m_scheduled = false;
+    m_meta = Meta();
+    m_working = m_meta;
+    m_free.clear();
+    m_freeAtBegin.clear();
+    m_freedThisTxn.clear();
+    m_dirty.clear();
+    m_lru.clear();
+    m_pool.clear();
+}
+
+bool StockDb::get(int id, Stock& stock) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_file && find(id, stock);
+}
+
+bool StockDb::find(int id, Stock& stock) {
+    PageId page = m_working.root;
+    while (page != NO_PAGE) {
+        NodePtr node = readNode(page);
+        if (!node) {
+            return false;
+        }
+        if (node->leaf) {
+            auto it = std::lower_bound(node->keys.begin(), node->keys.end(), id);
+            if (it == node->keys.end() || *it != id) {
+                return false;
+            }
+            stock = node->records[static_cast<std::size_t>(it - node->keys.begin())];
+            return true;
+        }
+        auto it = std::upper_bound(node->keys.begin(), node->keys.end(), id);
+        page = node->children[static_cast<std::size_t>(it - node->keys.begin())];
+    }
+    return false;
+}
+
+bool StockDb::checkPath(int id) {
+    PageId page = m_working.root;
+    while (page != NO_PAGE) {
+        NodePtr node = readNode(page);
+        if (!node) {
+            std::cerr << "Error writing stock catalog: page " << page << " is damaged" << std::endl;
+            return false;
+        }
+        if (node->leaf) {
+            return true;
+        }
+        auto it = std::upper_bound(node->keys.begin(), node->keys.end(), id);
+        page = node->children[static_cast<std::size_t>(it - node->keys.begin())];
+    }
+    return true;
+}
+
+bool StockDb::put(const Stock& stock) {
+    return putAll(std::pmr::vector<Stock>(1, stock));
+}
+
+bool StockDb::putAll(const std::pmr::vector<Stock>& stocks) {
+    static LatencyHistogram& latency = Metrics::histogram("store_write_stock");
+    Metrics::ScopedTimer timer(latency);
+    Trace::Span span("store_write_stock", "store");
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_file) {
+        return false;
+    }
+    for (const auto& stock : stocks) {
+        if (stock.getName().size() > MAX_NAME_LENGTH) {
+            std::cerr << "Error writing stock catalog: name of item " << stock.getId() << " is too long" << std::endl;
+            return false;
+        }
+        if (!checkPath(stock.getId())) {
+            return false;
+        }
+    }
+
+    begin();
+    try {
+        for (const auto& stock : stocks) {
+            bool added = false;
+            if (m_working.root == NO_PAGE) {
+                NodePtr leaf = std::make_shared<Node>();
+                leaf->keys.push_back(stock.getId());
+                leaf->records.push_back(stock);
+                m_working.root = storeNode(leaf);
+                m_working.height = 1;
+                added = true;
+            } else {
+                Change change = insert(m_working.root, stock, added);
+                m_working.root = change.page;
+                if (change.right != NO_PAGE) {
+                    NodePtr root = std::make_shared<Node>();
+                    root->leaf = false;
+                    root->keys.push_back(change.separator);
+                    root->children.push_back(change.page);
+                    root->children.push_back(change.right);
+                    m_working.root = storeNode(root);
+                    m_working.height++;
+                }
+            }
+            if (added) {
+                m_working.recordCount++;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error writing stock catalog: " << e.what() << std::endl;
+        rollback();
+        return false;
+    }
+    bool schedule = false;
+    bool saved = finishWrite(schedule);
+    lock.unlock();
+    if (schedule) {
+        scheduleCommit();
+    }
+    return saved;
+}
+
+bool StockDb::erase(int id) {
+    static LatencyHistogram& latency = Metrics::histogram("store_write_stock");
+    Metrics::ScopedTimer timer(latency);
+    Trace::Span span("store_write_stock", "store");
+    std::unique_lock<std::mutex> lock(m_mutex);
+    Stock existing;
+    if (!m_file || !checkPath(id) || !find(id, existing)) {
+        return false;
+    }
+
+    begin();
+    try {
+        Change change = remove(m_working.root, id);
+        m_working.root = change.removed ? NO_PAGE : change.page;
+        m_working.height = change.removed ? 0 : m_working.height;
+        // A root with a single child hands the root over to it
+        while (m_working.root != NO_PAGE && m_working.height > 1) {
+            NodePtr root = readNode(m_working.root);
+            if (!root) {
+                throw std::runtime_error("unreadable page");
+            }
+            if (root->children.size() != 1) {
+                break;
+            }
+            if (m_dirty.erase(m_working.root) > 0) {
+                m_free.push_back(m_working.root);
+            } else {
+                m_freedThisTxn.push_back(m_working.root);
+            }
+            m_working.root = root->children[0];
+            m_working.height--;
+        }
+        m_working.recordCount--;
+    } catch (const std::exception& e) {
+        std::cerr << "Error writing stock catalog: " << e.what() << std::endl;
+        rollback();
+        return false;
+    }
+    bool schedule = false;
+    bool saved = finishWrite(schedule);
+    lock.unlock();
+    if (schedule) {
+        scheduleCommit();
+    }
+    return saved;
+}
+
+bool StockDb::loadAll(std::pmr::vector<Stock>& stocks) {
+    Metrics::ScopedTimer timer("store_read_stock");
+    Trace::Span span("store_read_stock", "store");
+    std::lock_guard<std::mutex> lock(m_mutex);
+    stocks.clear();
+    if (!m_file) {
+        return false;
+    }
+    if (m_working.root == NO_PAGE) {
+        return true;
+    }
+    stocks.reserve(static_cast<std::size_t>(m_working.recordCount));
+    if (!collect(m_working.root, stocks)) {
+        stocks.clear();
+        return false;
+    }
+    if (stocks.size() != m_working.recordCount) {
+        std::cerr << "Error reading stock catalog: expected " << m_working.recordCount
+                  << " records, found " << stocks.size() << std::endl;
+        stocks.clear();
+        return false;
+    }
+    return true;
+}
+
+std::uint64_t StockDb::getRecordCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_working.recordCount;
+}
+
+StockDb::NodePtr StockDb::readNode(PageId page) {
+    auto dirty = m_dirty.find(page);
+    if (dirty != m_dirty.end()) {
+        return dirty->second;
+    }
+    auto pooled = m_pool.find(page);
+    if (pooled != m_pool.end()) {
+        m_lru.splice(m_lru.begin(), m_lru, pooled->second);
+        return pooled->second->second;
+    }
+    std::string bytes;
+    if (page < 2 || page >= m_working.pageCount || !readPage(page, bytes)) {
+        return nullptr;
+    }
+    NodePtr node = decode(bytes);
+    if (node) {
+        cache(page, node);
+    }
+    return node;
+}
+
+void StockDb::cache(PageId page, NodePtr node) {
+    auto pooled = m_pool.find(page);
+    if (pooled != m_pool.end()) {
+        pooled->second->second = node;
+        m_lru.splice(m_lru.begin(), m_lru, pooled->second);
+        return;
+    }
+    m_lru.emplace_front(page, node);
+    m_pool[page] = m_lru.begin();
+    if (m_lru.size() > POOL_PAGES) {
+        m_pool.erase(m_lru.back().first);
+        m_lru.pop_back();
+    }
+}
+
+// Pages written earlier in this transaction are changed in place; committed
+// pages are copied to a fresh page first
+StockDb::NodePtr StockDb::writableNode(PageId& page) {
+    auto dirty = m_dirty.find(page);
+    if (dirty != m_dirty.end()) {
+        return dirty->second;
+    }
+    NodePtr committed = readNode(page);
+    if (!committed) {
+        throw std::runtime_error("unreadable page " + std::to_string(page));
+    }
+    m_freedThisTxn.push_back(page);
+    NodePtr copy = std::make_shared<Node>(*committed);
+    page = storeNode(copy);
+    return copy;
+}
+
+StockDb::PageId StockDb::allocatePage() {
+    if (!m_free.empty()) {
+        PageId page = m_free.back();
+        m_free.pop_back();
+        return page;
+    }
+    return m_working.pageCount++;
+}
+
+StockDb::PageId StockDb::storeNode(NodePtr node) {
+    PageId page = allocatePage();
+    m_dirty[page] = node;
+    return page;
+}
+
+// Split a node that no longer fits in a page
+StockDb::Change StockDb::finish(PageId page, NodePtr node) {
+    Change change;
+    change.page = page;
+    if (encodedSize(*node) <= PAGE_SIZE) {
+        return change;
+    }
+    NodePtr right = std::make_shared<Node>();
+    right->leaf = node->leaf;
+    if (node->leaf) {
+        // Split by bytes, since names make records differ in size
+        std::size_t half = encodedSize(*node) / 2;
+        std::size_t bytes = NODE_HEADER;
+        std::size_t split = 0;
+        while (split < node->keys.size() && bytes < half) {
+            bytes += LEAF_ENTRY + node->records[split].getName().size();
+            split++;
+        }
+        split = std::max<std::size_t>(1, std::min(split, node->keys.size() - 1));
+        right->keys.assign(node->keys.begin() + split, node->keys.end());
+        right->records.assign(node->records.begin() + split, node->records.end());
+        node->keys.resize(split);
+        node->records.erase(node->records.begin() + split, node->records.end());
+        change.separator = right->keys.front();
+    } else {
+        std::size_t middle = node->keys.size() / 2;
+        change.separator = node->keys[middle];
+        right->keys.assign(node->keys.begin() + middle + 1, node->keys.end());
+        right->children.assign(node->children.begin() + middle + 1, node->children.end());
+        node->keys.resize(middle);
+        node->children.resize(middle + 1);
+    }
+    change.right = storeNode(right);
+    return change;
+}
+
+StockDb::Change StockDb::insert(PageId page, const Stock& stock, bool& added) {
+    NodePtr node = writableNode(page);
+    int id = stock.getId();
+    if (node->leaf) {
+        auto it = std::lower_bound(node->keys.begin(), node->keys.end(), id);
+        std::size_t index = static_cast<std::size_t>(it - node->keys.begin());
+        if (it != node->keys.end() && *it == id) {
+            node->records[index] = stock;
+        } else {
+            node->keys.insert(it, id);
+            node->records.insert(node->records.begin() + index, stock);
+            added = true;
+        }
+    } else {
+        auto it = std::upper_bound(node->keys.begin(), node->keys.end(), id);
+        std::size_t index = static_cast<std::size_t>(it - node->keys.begin());
+        Change child = insert(node->children[index], stock, added);
+        node->children[index] = child.page;
+        if (child.right != NO_PAGE) {
+            node->keys.insert(node->keys.begin() + index, child.separator);
+            node->children.insert(node->children.begin() + index + 1, child.right);
+        }
+    }
+    return finish(page, node);
+}
+
+// Nodes are not merged when they run low; a node is dropped once it is empty
+StockDb::Change StockDb::remove(PageId page, int id) {
+    NodePtr node = writableNode(page);
+    if (node->leaf) {
+        auto it = std::lower_bound(node->keys.begin(), node->keys.end(), id);
+        if (it != node->keys.end() && *it == id) {
+            node->records.erase(node->records.begin() + (it - node->keys.begin()));
+            node->keys.erase(it);
+        }
+    } else {
+        auto it = std::upper_bound(node->keys.begin(), node->keys.end(), id);
+        std::size_t index = static_cast<std::size_t>(it - node->keys.begin());
+        Change child = remove(node->children[index], id);
+        if (!child.removed) {
+            node->children[index] = child.page;
+        } else {
+            node->children.erase(node->children.begin() + index);
+            if (!node->keys.empty()) {
+                node->keys.erase(node->keys.begin() + (index == 0 ? 0 : index - 1));
+            }
+        }
+    }
+
+    Change change;
+    change.page = page;
+    if (node->leaf ? node->keys.empty() : node->children.empty()) {
+        // Written in this transaction only, so the page can be reused right away
+        m_dirty.erase(page);
+        m_free.push_back(page);
+        change.removed = true;
+    }
+    return change;
+}
+
+bool StockDb::collect(PageId page, std::pmr::vector<Stock>& out) {
+    NodePtr node = readNode(page);
+    if (!node) {
+        std::cerr << "Error reading stock catalog: page " << page << " is damaged" << std::endl;
+        return false;
+    }
+    if (node->leaf) {
+        out.insert(out.end(), node->records.begin(), node->records.end());
+        return true;
+    }
+    for (PageId child : node->children) {
+        if (!collect(child, out)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void StockDb::markReachable(PageId page, std::uint32_t depth, std::vector<bool>& reachable) {
+    if (page >= reachable.size() || reachable[page]) {
+        return;
+    }
+    reachable[page] = true;
+    if (depth >= m_meta.height) {
+        return;
+    }
+    NodePtr node = readNode(page);
+    if (!node) {
+        return;
+    }
+    for (PageId child : node->children) {
+        markReachable(child, depth + 1, reachable);
+    }
+}
+
+void StockDb::begin() {
+    if (m_pending) {
+        return; // carry on with the batch
+    }
+    m_working = m_meta;
+    m_freeAtBegin = m_free;
+    m_freedThisTxn.clear();
+    m_dirty.clear();
+}
+
+bool StockDb::finishWrite(bool& scheduleCommit) {
+    if (!m_pending && Durability::getBatchWindow().count() <= 0) {
+        if (!commit()) {
+            rollback();
+            return false;
+        }
+        return true;
+    }
+    // Joins the batch, including one whose commit failed and awaits a retry
+    m_pending = true;
+    scheduleCommit = !m_scheduled;
+    m_scheduled = true;
+    return true;
+}
+
+// Called without the lock held: with no window left (e.g. at exit) the commit runs right away
+void StockDb::scheduleCommit() {
+    Durability::schedule(m_filename, [this]() { return commitPending(); });
+}
+
+// put() and erase() have already reported the batch as saved, so a failed
+// commit keeps it: Durability runs this again, and the next write queues it too
+bool StockDb::commitPending() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_scheduled = false;
+    if (!m_pending || !m_file) {
+        return true;
+    }
+    if (!commit()) {
+        return false;
+    }
+    m_pending = false;
+    return true;
+}
+
+// New pages first, then the meta page that points at them, with a sync after
+// each so the meta page never reaches the disk ahead of the tree
+bool StockDb::commit() {
+    std::vector<PageId> pages;
+    pages.reserve(m_dirty.size());
+    for (const auto& entry : m_dirty) {
+        pages.push_back(entry.first);
+    }
+    std::sort(pages.begin(), pages.end());
+    for (PageId page : pages) {
+        if (!writePage(page, encode(*m_dirty[page]))) {
+            return false;
+        }
+    }
+    if (!pages.empty() && !sync()) {
+        return false;
+    }
+
+    m_working.txn = m_meta.txn + 1;
+    std::string meta(MAGIC, sizeof(MAGIC));
+    put64(meta, m_working.txn);
+    put32(meta, m_working.root);
+    put32(meta, m_working.pageCount);
+    put32(meta, m_working.height);
+    put64(meta, m_working.recordCount);
+    put32(meta, checksum(meta, meta.size()));
+    if (!writePage(static_cast<PageId>(m_working.txn % 2), meta) || !sync()) {
+        return false;
+    }
+
+    m_meta = m_working;
+    m_free.insert(m_free.end(), m_freedThisTxn.begin(), m_freedThisTxn.end());
+    m_freedThisTxn.clear();
+    for (PageId page : pages) {
+        cache(page, m_dirty[page]);
+    }
+    m_dirty.clear();
+    return true;
+}
+
+void StockDb::rollback() {
+    std::cerr << "Stock catalog change was not saved" << std::endl;
+    m_pending = false;
+    m_working = m_meta;
+    m_free = m_freeAtBegin;
+    m_freedThisTxn.clear();
+    m_dirty.clear();
+}
+
+bool StockDb::readMeta(PageId slot, Meta& meta) {
+    std::string bytes;
+    if (!readPage(slot, bytes) || !std::equal(MAGIC, MAGIC + sizeof(MAGIC), bytes.begin()) ||
+        getBytes(bytes, META_BODY - 4, 4) != checksum(bytes, META_BODY - 4)) {
+        return false;
+    }
+    meta.txn = getBytes(bytes, 4, 8);
+    meta.root = static_cast<PageId>(getBytes(bytes, 12, 4));
+    meta.pageCount = static_cast<PageId>(getBytes(bytes, 16, 4));
+    meta.height = static_cast<std::uint32_t>(getBytes(bytes, 20, 4));
+    meta.recordCount = getBytes(bytes, 24, 8);
+    return meta.pageCount >= 2 && meta.root < meta.pageCount;
+}
+
+bool StockDb::writePage(PageId page, const std::string& bytes) {
+    std::string padded = bytes;
+    padded.resize(PAGE_SIZE, '\0');
+    long offset = static_cast<long>(page) * static_cast<long>(PAGE_SIZE);
+    if (std::fseek(m_file, offset, SEEK_SET) != 0 ||
+        std::fwrite(padded.data(), 1, PAGE_SIZE, m_file) != PAGE_SIZE) {
+        // Commits may run on the Durability flusher thread, which must not print
+        Durability::reportError("Error writing stock catalog page " + std::to_string(page));
+        return false;
+    }
+    return true;
+}
+
+bool StockDb::readPage(PageId page, std::string& bytes) {
+    bytes.resize(PAGE_SIZE);
+    long offset = static_cast<long>(page) * static_cast<long>(PAGE_SIZE);
+    return std::fseek(m_file, offset, SEEK_SET) == 0 &&
+           std::fread(&bytes[0], 1, PAGE_SIZE, m_file) == PAGE_SIZE;
+}
+
+bool StockDb::sync() {
+    bool synced = std::fflush(m_file) == 0;
+#ifdef _WIN32
+    synced = synced && _commit(_fileno(m_file)) == 0;
+#else
+    synced = synced && fsync(fileno(m_file)) == 0;
+#endif
+    if (!synced) {
+        Durability::reportError("Error syncing stock catalog " + m_filename);
+    }
+    return synced;
+}
+
+std::size_t StockDb::encodedSize(const Node& node) {
+    std::size_t size = NODE_HEADER;
+    if (!node.leaf) {
+        return size + 4 + INTERNAL_ENTRY * node.keys.size();
+    }
+    for (const auto& stock : node.records) {
+        size += LEAF_ENTRY + stock.getName().size();
+    }
+    return size;
+}
+
+std::string StockDb::encode(const Node& node) {
+    std::string out;
+    out.reserve(PAGE_SIZE);
+    out.push_back(static_cast<char>(node.leaf ? LEAF : INTERNAL));
+    put16(out, static_cast<std::uint16_t>(node.keys.size()));
+    if (node.leaf) {
+        for (const auto& stock : node.records) {
+            const std::string& name = stock.getName();
+            put32(out, static_cast<std::uint32_t>(stock.getId()));
+            put32(out, static_cast<std::uint32_t>(stock.getQuantity()));
+            put64(out, static_cast<std::uint64_t>(stock.getPrice().getCents()));
+            put32(out, static_cast<std::uint32_t>(stock.getReorderThreshold()));
+            put16(out, static_cast<std::uint16_t>(name.size()));
+            out += name;
+        }
+    } else {
+        put32(out, node.children[0]);
+        for (std::size_t i = 0; i < node.keys.size(); ++i) {
+            put32(out, static_cast<std::uint32_t>(node.keys[i]));
+            put32(out, node.children[i + 1]);
+        }
+    }
+    return out;
+}
+
+StockDb::NodePtr StockDb::decode(const std::string& bytes) {
+    unsigned char type = static_cast<unsigned char>(bytes[0]);
+    if (type != LEAF && type != INTERNAL) {
+        return nullptr;
+    }
+    NodePtr node = std::make_shared<Node>();
+    node->leaf = type == LEAF;
+    std::size_t count = static_cast<std::size_t>(getBytes(bytes, 1, 2));
+    std::size_t pos = NODE_HEADER;
+    node->keys.reserve(count);
+    if (node->leaf) {
+        node->records.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            if (pos + LEAF_ENTRY > PAGE_SIZE) {
+                return nullptr;
+            }
+            int id = static_cast<std::int32_t>(getBytes(bytes, pos, 4));
+            int quantity = static_cast<std::int32_t>(getBytes(bytes, pos + 4, 4));
+            std::int64_t cents = static_cast<std::int64_t>(getBytes(bytes, pos + 8, 8));
+            int threshold = static_cast<std::int32_t>(getBytes(bytes, pos + 16, 4));
+            std::size_t length = static_cast<std::size_t>(getBytes(bytes, pos + 20, 2));
+            pos += LEAF_ENTRY;
+            if (pos + length > PAGE_SIZE) {
+                return nullptr;
+            }
+            node->keys.push_back(id);
+            node->records.emplace_back(id, bytes.substr(pos, length), quantity, Money::fromCents(cents), threshold);
+            pos += length;
+        }
+    } else {
+        if (pos + 4 + INTERNAL_ENTRY * count > PAGE_SIZE) {
+            return nullptr;
+        }
+        node->children.reserve(count + 1);
+        node->children.push_back(static_cast<PageId>(getBytes(bytes, pos, 4)));
+        pos += 4;
+        for (std::size_t i = 0; i < count; ++i) {
+            node->keys.push_back(static_cast<std::int32_t>(getBytes(bytes, pos, 4)));
+            node->children.push_back(static_cast<PageId>(getBytes(bytes, pos + 4, 4)));
+            pos += INTERNAL_ENTRY;
+        }
+    }
+    return node;
+}
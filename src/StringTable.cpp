@@ -0,0 +1,98 @@
+#include "../include/StringTable.hpp"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+    // Chunk k holds 256 << k strings, so stored strings never move and at most
+    // half of the allocated slots are unused
+    constexpr int FIRST_CHUNK_BITS = 8;
+    constexpr int CHUNK_COUNT = 32 - FIRST_CHUNK_BITS + 1;
+
+    // Plain arrays and atomics: usable from static constructors in any file.
+    // Chunks are never freed; they are needed until the last record goes away.
+    std::atomic<std::string*> chunks[CHUNK_COUNT];
+    std::atomic<std::uint32_t> count{0};
+
+    std::mutex writeMutex;
+    // Keys view the stored strings, which never move
+    std::unordered_map<std::string_view, StringTable::Handle>& index() {
+        static auto* map = new std::unordered_map<std::string_view, StringTable::Handle>();
+        return *map;
+    }
+
+    void locate(StringTable::Handle handle, int& chunk, std::size_t& offset) {
+        std::uint64_t position = static_cast<std::uint64_t>(handle) + (std::uint64_t{1} << FIRST_CHUNK_BITS);
+        int msb = FIRST_CHUNK_BITS;
+        while ((position >> (msb + 1)) != 0) {
+            msb++;
+        }
+        chunk = msb - FIRST_CHUNK_BITS;
+        offset = static_cast<std::size_t>(position - (std::uint64_t{1} << msb));
+    }
+}
+
+StringTable::Handle StringTable::intern(std::string_view text) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    auto& map = index();
+    if (count.load(std::memory_order_relaxed) == 0) {
+        // Slot 0 is always the empty string
+        chunks[0].store(new std::string[std::size_t{1} << FIRST_CHUNK_BITS], std::memory_order_release);
+        map.emplace(std::string_view(), EMPTY);
+        count.store(1, std::memory_order_release);
+    }
+    auto it = map.find(text);
+    if (it != map.end()) {
+        return it->second;
+    }
+
+    Handle handle = count.load(std::memory_order_relaxed);
+    if (handle == UINT32_MAX) {
+        throw std::length_error("string table is full");
+    }
+    int chunk = 0;
+    std::size_t offset = 0;
+    locate(handle, chunk, offset);
+    std::string* slots = chunks[chunk].load(std::memory_order_relaxed);
+    if (!slots) {
+        slots = new std::string[std::size_t{1} << (chunk + FIRST_CHUNK_BITS)];
+        chunks[chunk].store(slots, std::memory_order_release);
+    }
+    slots[offset].assign(text.data(), text.size());
+    map.emplace(std::string_view(slots[offset]), handle);
+    count.store(handle + 1, std::memory_order_release);
+    return handle;
+}
+
+bool StringTable::lookup(std::string_view text, Handle& handle) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (text.empty()) {
+        handle = EMPTY;
+        return true;
+    }
+    auto& map = index();
+    auto it = map.find(text);
+    if (it == map.end()) {
+        return false;
+    }
+    handle = it->second;
+    return true;
+}
+
+const std::string& StringTable::get(Handle handle) {
+    static const std::string empty;
+    if (handle >= count.load(std::memory_order_acquire)) {
+        return empty; // EMPTY before anything was interned, or a bad handle
+    }
+    int chunk = 0;
+    std::size_t offset = 0;
+    locate(handle, chunk, offset);
+    return chunks[chunk].load(std::memory_order_acquire)[offset];
+}
+
+std::size_t StringTable::size() {
+    std::uint32_t stored = count.load(std::memory_order_acquire);
+    return stored == 0 ? 1 : stored;
+}
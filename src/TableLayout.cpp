@@ -0,0 +1,77 @@
+#include "../include/TableLayout.hpp"
+#include <string>
+
+namespace Layout {
+
+namespace {
+const std::string SPACES(TERMINAL_WIDTH, ' ');
+}
+
+const char* margin() {
+    return SPACES.c_str() + (SPACES.size() - LEFT_PADDING);
+}
+
+void fill(std::ostream& out, int count) {
+    while (count > 0) {
+        int chunk = count < static_cast<int>(SPACES.size()) ? count : static_cast<int>(SPACES.size());
+        out.write(SPACES.data(), chunk);
+        count -= chunk;
+    }
+}
+
+std::ostream& operator<<(std::ostream& out, const Indented& indented) {
+    out.write(SPACES.data(), LEFT_PADDING);
+    out.write(indented.text.data(), static_cast<std::streamsize>(indented.text.size()));
+    return out;
+}
+
+std::ostream& operator<<(std::ostream& out, const Centered& centered) {
+    int length = static_cast<int>(centered.text.size());
+    int spacesLeft = length < centered.width ? (centered.width - length) / 2 : 0;
+    int spacesRight = length < centered.width ? centered.width - length - spacesLeft : 0;
+    fill(out, spacesLeft);
+    out.write(centered.text.data(), static_cast<std::streamsize>(centered.text.size()));
+    fill(out, spacesRight);
+    return out;
+}
+
+const char* escape(Color color) {
+    switch (color) {
+        case Color::Red:     return "\033[91m";
+        case Color::Green:   return "\033[92m";
+        case Color::Yellow:  return "\033[93m";
+        case Color::Blue:    return "\033[94m";
+        case Color::Magenta: return "\033[95m";
+        case Color::Cyan:    return "\033[96m";
+        case Color::White:   return "\033[97m";
+        default:             return "";
+    }
+}
+
+void writeCell(std::ostream& out, std::string_view text, int width, Align align) {
+    int room = width - 2; // one space of padding on each side
+    if (static_cast<int>(text.size()) > room && room <= 3) {
+        out << ' ';
+        out.write(text.data(), room);
+        out << ' ';
+        return;
+    }
+    if (static_cast<int>(text.size()) > room) {
+        out << ' ';
+        out.write(text.data(), room - 3);
+        out << "... ";
+        return;
+    }
+    int length = static_cast<int>(text.size());
+    int before = 1;
+    if (align == Align::Right) {
+        before = width - 1 - length;
+    } else if (align == Align::Center) {
+        before = (width - length) / 2;
+    }
+    fill(out, before);
+    out.write(text.data(), length);
+    fill(out, width - before - length);
+}
+
+} // namespace Layout
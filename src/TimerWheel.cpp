@@ -0,0 +1,151 @@
+#include "../include/TimerWheel.hpp"
+
+TimerWheel::TimerWheel(std::uint64_t startTick) : m_currentTick(startTick), m_count(0) {
+    for (auto& level : m_slots) {
+        for (auto& head : level) {
+            head = -1;
+        }
+    }
+}
+
+TimerWheel::TimerId TimerWheel::schedule(std::uint64_t expiryTick, std::uint64_t payload) {
+    std::int32_t index;
+    if (!m_freeNodes.empty()) {
+        index = m_freeNodes.back();
+        m_freeNodes.pop_back();
+    } else {
+        index = static_cast<std::int32_t>(m_nodes.size());
+        m_nodes.push_back(Node{0, 0, -1, -1, -1, 0, false});
+    }
+
+    Node& node = m_nodes[index];
+    // A timer that is already due fires on the next tick
+    node.expiry = expiryTick > m_currentTick ? expiryTick : m_currentTick + 1;
+    node.payload = payload;
+    node.generation++;
+    if (node.generation == 0) {
+        node.generation = 1;
+    }
+    node.active = true;
+    link(index);
+    m_count++;
+
+    return (static_cast<TimerId>(node.generation) << 32) | static_cast<std::uint32_t>(index);
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    std::int32_t index = static_cast<std::int32_t>(id & 0xffffffffu);
+    std::uint32_t generation = static_cast<std::uint32_t>(id >> 32);
+    if (id == INVALID_TIMER || index < 0 || index >= static_cast<std::int32_t>(m_nodes.size())) {
+        return false;
+    }
+
+    Node& node = m_nodes[index];
+    if (!node.active || node.generation != generation) {
+        return false;
+    }
+    unlink(index);
+    node.active = false;
+    m_freeNodes.push_back(index);
+    m_count--;
+    return true;
+}
+
+void TimerWheel::advance(std::uint64_t nowTick, const std::function<void(std::uint64_t)>& onExpire) {
+    while (m_currentTick < nowTick) {
+        if (m_count == 0) {
+            // Nothing pending, skip the idle ticks in one step
+            m_currentTick = nowTick;
+            return;
+        }
+        m_currentTick++;
+
+        // Pull timers down from the coarser levels when the finer level wraps
+        for (int level = 1; level < LEVELS; ++level) {
+            std::uint64_t lowerBits = m_currentTick & ((std::uint64_t(1) << (SLOT_BITS * level)) - 1);
+            if (lowerBits != 0) {
+                break;
+            }
+            cascade(level);
+        }
+
+        // Fire everything in the current level-0 slot
+        std::int32_t& head = m_slots[0][m_currentTick & SLOT_MASK];
+        std::int32_t index = head;
+        head = -1;
+        while (index != -1) {
+            Node& node = m_nodes[index];
+            std::int32_t next = node.next;
+            std::uint64_t payload = node.payload;
+            node.active = false;
+            m_freeNodes.push_back(index);
+            m_count--;
+            // The callback may schedule new timers, so no Node reference is used after it
+            onExpire(payload);
+            index = next;
+        }
+    }
+}
+
+std::uint64_t TimerWheel::getCurrentTick() const {
+    return m_currentTick;
+}
+
+std::size_t TimerWheel::size() const {
+    return m_count;
+}
+
+// Put a node in the slot that matches its distance from the current tick
+void TimerWheel::link(std::int32_t index) {
+    Node& node = m_nodes[index];
+    std::uint64_t delta = node.expiry > m_currentTick ? node.expiry - m_currentTick : 0;
+
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (std::uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+
+    std::uint64_t expiry = node.expiry;
+    std::uint64_t maxDelta = (std::uint64_t(1) << (SLOT_BITS * LEVELS)) - 1;
+    if (delta > maxDelta) {
+        // Too far out for the wheel: park it at the horizon, it is re-linked on cascade
+        expiry = m_currentTick + maxDelta;
+    }
+
+    std::int32_t slot = static_cast<std::int32_t>((expiry >> (SLOT_BITS * level)) & SLOT_MASK);
+    std::int32_t& head = m_slots[level][slot];
+    node.bucket = level * SLOTS + slot;
+    node.prev = -1;
+    node.next = head;
+    if (head != -1) {
+        m_nodes[head].prev = index;
+    }
+    head = index;
+}
+
+void TimerWheel::unlink(std::int32_t index) {
+    Node& node = m_nodes[index];
+    if (node.prev != -1) {
+        m_nodes[node.prev].next = node.next;
+    } else {
+        // The node is the head of its slot
+        m_slots[node.bucket / SLOTS][node.bucket % SLOTS] = node.next;
+    }
+    if (node.next != -1) {
+        m_nodes[node.next].prev = node.prev;
+    }
+    node.prev = -1;
+    node.next = -1;
+}
+
+// Re-link every timer of the current slot of a coarser level into finer levels
+void TimerWheel::cascade(int level) {
+    std::int32_t& head = m_slots[level][(m_currentTick >> (SLOT_BITS * level)) & SLOT_MASK];
+    std::int32_t index = head;
+    head = -1;
+    while (index != -1) {
+        std::int32_t next = m_nodes[index].next;
+        link(index);
+        index = next;
+    }
+}
@@ -0,0 +1,91 @@
+#include "../include/TopSellers.hpp"
+#include <algorithm>
+#include <unordered_map>
+
+TopSellers::TopSellers(std::size_t capacity, long long paneSeconds, std::size_t paneCount)
+    : m_paneSeconds(paneSeconds > 0 ? paneSeconds : 3600),
+      m_allTimeUnits(capacity),
+      m_allTimeRevenueCents(capacity) {
+    m_panes.reserve(paneCount == 0 ? 1 : paneCount);
+    for (std::size_t i = 0; i < std::max<std::size_t>(paneCount, 1); ++i) {
+        Pane pane;
+        pane.units = SpaceSaving(capacity);
+        pane.revenueCents = SpaceSaving(capacity);
+        m_panes.push_back(std::move(pane));
+    }
+}
+
+void TopSellers::addReceipt(const Receipt& receipt) {
+    for (const auto& item : receipt.getItems()) {
+        record(receipt.getTransactionTime(), item.itemId, item.quantity, item.unitPrice * item.quantity);
+    }
+}
+
+void TopSellers::record(std::time_t time, int itemId, long long units, Money revenue) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_allTimeUnits.offer(itemId, units);
+    m_allTimeRevenueCents.offer(itemId, revenue.getCents());
+
+    long long number = static_cast<long long>(time) / m_paneSeconds;
+    Pane& pane = m_panes[static_cast<std::size_t>(number % static_cast<long long>(m_panes.size()))];
+    if (pane.number > number) {
+        return; // older than anything the ring still covers
+    }
+    if (pane.number < number) {
+        // The slot held a pane that has slid out of every window: recycle it
+        pane.number = number;
+        pane.units.clear();
+        pane.revenueCents.clear();
+    }
+    pane.units.offer(itemId, units);
+    pane.revenueCents.offer(itemId, revenue.getCents());
+}
+
+std::vector<std::pair<int, long long>> TopSellers::getTop(std::size_t k, long long windowSeconds,
+                                                          std::time_t now, bool byRevenue) const {
+    std::unordered_map<int, long long> totals;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (windowSeconds <= 0) {
+            const SpaceSaving& summary = byRevenue ? m_allTimeRevenueCents : m_allTimeUnits;
+            for (const auto& counter : summary.getCounters()) {
+                totals[counter.key] += counter.count;
+            }
+        } else {
+            long long newest = static_cast<long long>(now) / m_paneSeconds;
+            long long oldest = (static_cast<long long>(now) - windowSeconds) / m_paneSeconds + 1;
+            oldest = std::max(oldest, newest - static_cast<long long>(m_panes.size()) + 1);
+            for (const auto& pane : m_panes) {
+                if (pane.number < oldest || pane.number > newest) {
+                    continue;
+                }
+                const SpaceSaving& summary = byRevenue ? pane.revenueCents : pane.units;
+                for (const auto& counter : summary.getCounters()) {
+                    totals[counter.key] += counter.count;
+                }
+            }
+        }
+    }
+
+    std::vector<std::pair<int, long long>> top(totals.begin(), totals.end());
+    k = std::min(k, top.size());
+    std::partial_sort(top.begin(), top.begin() + k, top.end(), [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    top.resize(k);
+    return top;
+}
+
+std::vector<std::pair<int, long long>> TopSellers::getTopByUnits(std::size_t k, long long windowSeconds,
+                                                                 std::time_t now) const {
+    return getTop(k, windowSeconds, now, false);
+}
+
+std::vector<std::pair<int, Money>> TopSellers::getTopByRevenue(std::size_t k, long long windowSeconds,
+                                                               std::time_t now) const {
+    std::vector<std::pair<int, Money>> top;
+    for (const auto& entry : getTop(k, windowSeconds, now, true)) {
+        top.emplace_back(entry.first, Money::fromCents(entry.second));
+    }
+    return top;
+}
@@ -0,0 +1,154 @@
+#include "../include/Trace.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+    struct Event {
+        const char* name;
+        const char* category;
+        std::int64_t startMicros; // since the trace started
+        std::int64_t durationMicros;
+    };
+
+    // Events of one thread. Only that thread appends, so the lock is uncontended
+    // except while stop() drains it.
+    struct ThreadBuffer {
+        std::mutex mutex;
+        std::vector<Event> events;
+        unsigned threadId = 0;
+    };
+
+    std::atomic<bool> enabled{false};
+    std::chrono::steady_clock::time_point traceStart;
+
+    // Buffers of every thread that has recorded a span; kept alive here after
+    // their thread exits so its events still reach the file
+    std::mutex registryMutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::string traceFile;
+    unsigned nextThreadId = 1;
+
+    // Writes the trace during static destruction if nobody stopped it
+    struct StopGuard {
+        ~StopGuard() { Trace::stop(); }
+    } stopGuard;
+
+    ThreadBuffer& localBuffer() {
+        thread_local std::shared_ptr<ThreadBuffer> buffer;
+        if (!buffer) {
+            buffer = std::make_shared<ThreadBuffer>();
+            buffer->events.reserve(1024);
+            std::lock_guard<std::mutex> lock(registryMutex);
+            buffer->threadId = nextThreadId++;
+            buffers.push_back(buffer);
+        }
+        return *buffer;
+    }
+
+    std::int64_t sinceStart(std::chrono::steady_clock::time_point time) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(time - traceStart).count();
+    }
+
+    void writeString(std::ostream& out, const char* text) {
+        out << '"';
+        for (const char* c = text; *c; ++c) {
+            if (*c == '"' || *c == '\\') {
+                out << '\\';
+            }
+            out << *c;
+        }
+        out << '"';
+    }
+}
+
+void Trace::start(const std::string& filename) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    if (enabled.load()) {
+        return;
+    }
+    traceFile = filename;
+    traceStart = std::chrono::steady_clock::now();
+    for (auto& buffer : buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->events.clear();
+    }
+    enabled.store(true);
+}
+
+bool Trace::startFromEnvironment() {
+    const char* filename = std::getenv(ENVIRONMENT_VARIABLE);
+    if (filename && *filename) {
+        start(filename);
+    }
+    return isEnabled();
+}
+
+bool Trace::isEnabled() {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+bool Trace::stop() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    if (!enabled.exchange(false)) {
+        return false;
+    }
+
+    fs::path parent = fs::path(traceFile).parent_path();
+    std::error_code ec;
+    if (!parent.empty()) {
+        fs::create_directories(parent, ec);
+    }
+    std::ofstream out(traceFile, std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    for (auto& buffer : buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        for (const Event& event : buffer->events) {
+            out << (first ? "" : ",\n") << "{\"name\":";
+            writeString(out, event.name);
+            out << ",\"cat\":";
+            writeString(out, event.category);
+            out << ",\"ph\":\"X\",\"ts\":" << event.startMicros << ",\"dur\":" << event.durationMicros
+                << ",\"pid\":1,\"tid\":" << buffer->threadId << "}";
+            first = false;
+        }
+        buffer->events.clear();
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+Trace::Span::Span(const char* name, const char* category)
+    : m_name(name), m_category(category), m_active(isEnabled()) {
+    if (m_active) {
+        m_start = std::chrono::steady_clock::now();
+    }
+}
+
+Trace::Span::~Span() {
+    stop();
+}
+
+void Trace::Span::stop() {
+    if (!m_active || !isEnabled()) {
+        return;
+    }
+    m_active = false;
+    auto end = std::chrono::steady_clock::now();
+    ThreadBuffer& buffer = localBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.events.push_back({m_name, m_category, sinceStart(m_start),
+                             std::chrono::duration_cast<std::chrono::microseconds>(end - m_start).count()});
+}
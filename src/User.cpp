@@ -1,18 +1,30 @@
 #include "../include/User.hpp"
+#include "../include/MemoryTracker.hpp"
+
+namespace {
+    std::pmr::memory_resource* userMemory() {
+        return MemoryTracker::resource(MemoryTracker::Subsystem::Users);
+    }
+}
 
 // Default constructor implementation
-User::User() : m_username(""), m_password(""), m_isAdmin(false) {}
+User::User() : m_username(userMemory()), m_password(userMemory()), m_isAdmin(false) {}
 
 // Parameterized constructor implementation
-User::User(const std::string& username, const std::string& password, bool isAdmin)
-    : m_username(username), m_password(password), m_isAdmin(isAdmin) {}
+User::User(std::string_view username, std::string_view password, bool isAdmin)
+    : m_username(username, userMemory()), m_password(password, userMemory()), m_isAdmin(isAdmin) {}
+
+// A plain pmr::string copy would fall back to the default resource
+User::User(const User& other)
+    : m_username(other.m_username, userMemory()), m_password(other.m_password, userMemory()),
+      m_isAdmin(other.m_isAdmin) {}
 
 // Getter implementations
-std::string User::getUsername() const {
+std::string_view User::getUsername() const {
     return m_username;
 }
 
-std::string User::getPassword() const {
+std::string_view User::getPassword() const {
     return m_password;
 }
 
@@ -21,11 +33,11 @@ bool User::isAdmin() const {
 }
 
 // Setter implementations
-void User::setUsername(const std::string& username) {
+void User::setUsername(std::string_view username) {
     m_username = username;
 }
 
-void User::setPassword(const std::string& password) {
+void User::setPassword(std::string_view password) {
     m_password = password;
 }
 
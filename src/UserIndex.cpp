@@ -0,0 +1,110 @@
+#include "../include/UserIndex.hpp"
+#include <functional>
+
+namespace {
+    // Second, independent hash derived from the first (splitmix64 finaliser)
+    std::uint64_t mix(std::uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+}
+
+void UserIndex::rebuild(const std::pmr::vector<User>& users) {
+    m_positions.clear();
+    m_positions.reserve(users.size());
+    resizeBloom(users.size());
+    for (std::size_t i = 0; i < users.size(); ++i) {
+        if (m_positions.emplace(users[i].getUsername(), i).second) {
+            addToBloom(std::hash<std::string_view>{}(users[i].getUsername())); // same value as hash<string>
+        }
+    }
+}
+
+void UserIndex::insert(const std::string& username, std::size_t position) {
+    if (!m_positions.emplace(username, position).second) {
+        return;
+    }
+    if (m_positions.size() > m_bloomCapacity) {
+        // Filter is full enough to lose its precision: size it up and refill
+        resizeBloom(m_positions.size() * 2);
+        for (const auto& entry : m_positions) {
+            addToBloom(std::hash<std::string>{}(entry.first));
+        }
+    } else {
+        addToBloom(std::hash<std::string>{}(username));
+    }
+}
+
+void UserIndex::erase(const std::string& username, std::size_t position, const std::pmr::vector<User>& users) {
+    // Bloom bits cannot be cleared; a stale bit only costs one map lookup
+    auto it = m_positions.find(username);
+    if (it != m_positions.end() && it->second == position) {
+        m_positions.erase(it);
+    }
+    for (std::size_t i = position; i < users.size(); ++i) {
+        auto entry = m_positions.find(std::string(users[i].getUsername()));
+        if (entry != m_positions.end() && entry->second == i + 1) {
+            entry->second = i;
+        } else if (entry == m_positions.end()) {
+            // A duplicate name that was hidden by the removed account
+            m_positions.emplace(users[i].getUsername(), i);
+        }
+    }
+}
+
+int UserIndex::find(const std::string& username) const {
+    if (!mayContain(std::hash<std::string>{}(username))) {
+        return NOT_FOUND;
+    }
+    auto it = m_positions.find(username);
+    return it == m_positions.end() ? NOT_FOUND : static_cast<int>(it->second);
+}
+
+bool UserIndex::contains(const std::string& username) const {
+    return find(username) != NOT_FOUND;
+}
+
+std::size_t UserIndex::size() const {
+    return m_positions.size();
+}
+
+void UserIndex::resizeBloom(std::size_t expectedUsers) {
+    if (expectedUsers < 64) {
+        expectedUsers = 64;
+    }
+    std::size_t words = 1;
+    while (words * 64 < expectedUsers * BLOOM_BITS_PER_USER) {
+        words <<= 1;
+    }
+    m_bloom.assign(words, 0);
+    m_bloomCapacity = expectedUsers;
+}
+
+// Double hashing: bit i is h1 + i * h2, masked to the power-of-two bit count
+void UserIndex::addToBloom(std::uint64_t hash) {
+    std::uint64_t mask = m_bloom.size() * 64 - 1;
+    std::uint64_t step = mix(hash) | 1;
+    for (int i = 0; i < BLOOM_HASHES; ++i) {
+        std::uint64_t bit = (hash + i * step) & mask;
+        m_bloom[bit >> 6] |= 1ULL << (bit & 63);
+    }
+}
+
+bool UserIndex::mayContain(std::uint64_t hash) const {
+    if (m_bloom.empty()) {
+        return false;
+    }
+    std::uint64_t mask = m_bloom.size() * 64 - 1;
+    std::uint64_t step = mix(hash) | 1;
+    for (int i = 0; i < BLOOM_HASHES; ++i) {
+        std::uint64_t bit = (hash + i * step) & mask;
+        if ((m_bloom[bit >> 6] & (1ULL << (bit & 63))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
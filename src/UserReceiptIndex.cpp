@@ -0,0 +1,22 @@
+#include "../include/UserReceiptIndex.hpp"
+
+void UserReceiptIndex::rebuild(const std::pmr::vector<Receipt>& receipts) {
+    m_postings.clear();
+    for (std::size_t i = 0; i < receipts.size(); ++i) {
+        m_postings[receipts[i].getUsernameHandle()].push_back(i);
+    }
+}
+
+void UserReceiptIndex::add(const std::string& username, std::size_t position) {
+    m_postings[StringTable::intern(username)].push_back(position);
+}
+
+const std::pmr::vector<std::size_t>& UserReceiptIndex::getReceipts(const std::string& username) const {
+    static const std::pmr::vector<std::size_t> none;
+    StringTable::Handle user;
+    if (!StringTable::lookup(username, user)) {
+        return none;
+    }
+    auto it = m_postings.find(user);
+    return it == m_postings.end() ? none : it->second;
+}
@@ -8,18 +8,43 @@
 #include <stdexcept> // for exception handling
 #include <numeric> // for accumulate
 #include <ctime> // for time_t
+#include <functional> // for reference_wrapper
 #include "../include/User.hpp"
 #include "../include/Stock.hpp"
 #include "../include/ExcelUtil.hpp"
 #include "../include/DisplayUtil.hpp"
 #include "../include/Receipt.hpp"
+#include "../include/ReceiptStore.hpp"
+#include "../include/StockDb.hpp"
+#include "../include/CheckoutEngine.hpp"
+#include "../include/CartStore.hpp"
+#include "../include/Durability.hpp"
+#include "../include/UserIndex.hpp"
+#include "../include/SalesAnalytics.hpp"
+#include "../include/TopSellers.hpp"
+#include "../include/ReceiptTimeIndex.hpp"
+#include "../include/UserReceiptIndex.hpp"
+#include "../include/RestockPlanner.hpp"
+#include "../include/StockAlerts.hpp"
+#include "../include/ScreenRenderer.hpp"
+#include "../include/TableLayout.hpp"
+#include "../include/MemoryTracker.hpp"
+#include "../include/Metrics.hpp"
+#include "../include/Trace.hpp"
 #include <windows.h>
 #include <conio.h>  
 #include <filesystem>  
 #include <thread>
 #include <chrono>
 using namespace std;
-const int LOW_STOCK_THRESHOLD = 20; 
+using Layout::padLeft;
+using Layout::centerText;
+const int LOW_STOCK_THRESHOLD = Stock::DEFAULT_REORDER_THRESHOLD; // Default reorder level of new items
+const int CART_RESERVATION_TTL = 15 * 60; // seconds a cart holds its items
+const int METRICS_EXPORT_SECONDS = 60; // how often data/metrics.prom is rewritten
+const string RECEIPT_STORE_FILE = "data/transactions.rcs"; // receipt history, see ReceiptStore
+const string STOCK_DB_FILE = "data/stock.db"; // stock catalog, see StockDb
+const int DURABILITY_WINDOW_MS = 100; // saves within this window share one sync; 0 syncs every save
 namespace fs = filesystem;
 
 // Platform-specific includes for password masking
@@ -44,8 +69,10 @@ void addStock();
 void updateStock();
 void deleteStock();
 void displayAllStocks();
+size_t browseStocks(size_t first);
 void trackInventory();
 void generateLowStockAlerts();
+void displayMemoryUsage();
 void printStockReport();
 string getPasswordInput(const string& prompt);
 void backupStockData();
@@ -53,23 +80,74 @@ void backupStockData();
 // for User
 void addItemToCart();
 void viewCart(); 
+void viewMyPurchases();
 void buyStock();
 void checkoutCart(const string& username);
 void gotoxy(int x, int y) {
-    COORD coord;
-    coord.X = x;
-    coord.Y = y;
-    SetConsoleCursorPosition(GetStdHandle(STD_OUTPUT_HANDLE), coord);
+    // Sent in order with the buffered frame instead of moving the console cursor directly
+    ScreenRenderer::moveCursor(x, y);
+}
+// Wait for a key press; the frame drawn so far is shown first
+int readKey() {
+    ScreenRenderer::present();
+    return _getch();
 }
 void deleteUser();
 
 // Global data storage
-vector<User> users;
-vector<Stock> stocks;
-vector<Receipt> receipts;  // Store all receipts
-vector<pair<Stock, int>> cart; // Global cart to hold items added by users
+// The collections charge their memory to their subsystem, see MemoryTracker
+pmr::vector<User> users{MemoryTracker::resource(MemoryTracker::Subsystem::Users)};
+UserIndex userIndex; // Username lookups into users; update it whenever users changes
+pmr::vector<Stock> stocks{MemoryTracker::resource(MemoryTracker::Subsystem::Stocks)};
+StockDb stockDb; // The catalog on disk; write each changed record through to it
+pmr::vector<Receipt> receipts{MemoryTracker::resource(MemoryTracker::Subsystem::Receipts)}; // Store all receipts
+SalesAnalytics salesAnalytics; // Revenue and sales rollups over receipts
+TopSellers topSellers; // Streaming best sellers over sliding time windows
+ReceiptTimeIndex receiptTimeIndex; // Receipts ordered by transaction time
+UserReceiptIndex userReceiptIndex; // Receipts of each user, for purchase history
+RestockPlanner restockPlanner; // Sales velocity per item for restock suggestions
+StockAlerts stockAlerts; // Low-stock alerts raised as quantities cross their thresholds
+CartStore carts; // Shopping carts of every user, persisted to data/carts.log
+CheckoutEngine checkoutEngine; // Per-SKU atomic quantities shared by all cashiers
 User* currentUser = nullptr;
 
+// Find a catalog record by stock ID, or nullptr if it no longer exists
+Stock* findStockById(int id) {
+    static LatencyHistogram& latency = Metrics::histogram("lookup");
+    Metrics::ScopedTimer timer(latency);
+    auto it = find_if(stocks.begin(), stocks.end(), [id](const Stock& s) {
+        return s.getId() == id;
+    });
+    return it == stocks.end() ? nullptr : &*it;
+}
+
+// Shown when the catalog file rejects a change; what happened is in the error output
+void displayCatalogWriteError(const string& detail) {
+    cout << "\n" << padLeft("\033[91m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
+    cout << padLeft("║") << "\033[93m" << centerText("❌ NOT SAVED!") << "\033[91m" << " ║\n";
+    cout << padLeft("║") << "\033[96m" << centerText(detail) << "\033[91m" << "║\n";
+    cout << padLeft("║") << "\033[94m" << centerText("The stock catalog file could not be written") << "\033[91m" << "║\n";
+    cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
+}
+
+// Saves that failed on the Durability thread since the last check, which
+// cannot print them itself. Shown below the current screen until a key press.
+void displaySaveErrors() {
+    vector<string> errors = Durability::takeErrors();
+    if (errors.empty()) {
+        return;
+    }
+    cout << "\n" << padLeft("\033[91m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
+    cout << padLeft("║") << "\033[93m" << centerText("❌ NOT SAVED!") << "\033[91m" << " ║\n";
+    for (const string& error : errors) {
+        string line = error.length() > 76 ? error.substr(0, 73) + "..." : error;
+        cout << padLeft("║") << "\033[96m" << centerText(line) << "\033[91m" << "║\n";
+    }
+    cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
+    cout << "\n" << padLeft("\033[93m⚠️  Press any key to continue...\033[0m") << "\n";
+    readKey();
+}
+
 string getPasswordInput(const string& prompt) {
     string password;
     cout << prompt;
@@ -156,32 +234,99 @@ string getPasswordInput(const string& prompt) {
 // ─── Main Function ──────────────────────────────────────────────
 int main() {
     system("chcp 65001 > nul");
+    ScreenRenderer::install();
     string lightBlue = "\033[94m";
     string cyan = "\033[36m";
     string reset = "\033[0m";
+    Trace::startFromEnvironment(); // ASSET_TRACE=<file> records a timeline
+    Durability::setBatchWindow(chrono::milliseconds(DURABILITY_WINDOW_MS));
     try {
         // DisplayUtil::displayWelcome();
 
+        Trace::Span startupSpan("startup");
         users = ExcelUtil::readUsersFromFile("data/users.xlsx");
         if (users.empty()) {
             users.emplace_back("admin", "adminpass", true);
             ExcelUtil::writeUsersToFile("data/users.xlsx", users);
         }
-
-        receipts = ExcelUtil::readTransactionsFromFile("data/transactions.xlsx");
-        if (receipts.empty()) {
+        userIndex.rebuild(users);
+
+        // The columnar store is the history; the spreadsheet is only imported
+        // when there is no store yet. A damaged store is left as it is: the
+        // spreadsheet is older, and importing it would overwrite the history.
+        if (fs::exists(RECEIPT_STORE_FILE)) {
+            if (!ReceiptStore::load(RECEIPT_STORE_FILE, receipts)) {
+                cerr << "Cannot start: " << RECEIPT_STORE_FILE << " could not be read. "
+                     << "Restore it from a backup, or move it aside to re-import data/transactions.xlsx." << endl;
+                return 1;
+            }
+        } else {
+            receipts = ExcelUtil::readTransactionsFromFile("data/transactions.xlsx");
+            if (!receipts.empty()) {
+                ReceiptStore::save(RECEIPT_STORE_FILE, receipts);
+            }
+        }
+        {
+            Trace::Span span("build_receipt_indexes");
+            salesAnalytics.build(receipts);
+            receiptTimeIndex.rebuild(receipts);
+            userReceiptIndex.rebuild(receipts);
+            restockPlanner.rebuild(receipts);
+            for (const auto& receipt : receipts) {
+                topSellers.addReceipt(receipt);
+            }
         }
 
-        stocks = ExcelUtil::readStockFromFile("data/stock.xlsx");
-        if (stocks.empty()) {
-            stocks.emplace_back(1, "Laptop", 10, 599.99);
-            stocks.emplace_back(2, "Mouse", 30, 12.5);
-            stocks.emplace_back(3, "Keyboard", 20, 25.0);
-            ExcelUtil::writeStockToFile("data/stock.xlsx", stocks);
+        // The page file is the catalog; the spreadsheet is only imported once.
+        // As with the receipts, a damaged catalog stops startup and is kept.
+        bool catalogExists = fs::exists(STOCK_DB_FILE);
+        if (!stockDb.open(STOCK_DB_FILE)) {
+            cerr << "Cannot start: the stock catalog " << STOCK_DB_FILE << " could not be opened." << endl;
+            return 1;
         }
+        if (catalogExists) {
+            if (!stockDb.loadAll(stocks)) {
+                cerr << "Cannot start: " << STOCK_DB_FILE << " is damaged. "
+                     << "Restore it from a backup, or move it aside to re-import data/stock.xlsx." << endl;
+                return 1;
+            }
+        } else {
+            stocks = ExcelUtil::readStockFromFile("data/stock.xlsx");
+            if (stocks.empty()) {
+                stocks.emplace_back(1, "Laptop", 10, Money::fromCents(59999));
+                stocks.emplace_back(2, "Mouse", 30, Money::fromCents(1250));
+                stocks.emplace_back(3, "Keyboard", 20, Money::fromCents(2500));
+            }
+            if (!stockDb.putAll(stocks)) {
+                // Drop the new, empty file so the next start imports again
+                stockDb.close();
+                fs::remove(STOCK_DB_FILE);
+                cerr << "Cannot start: the stock catalog could not be written to " << STOCK_DB_FILE << "." << endl;
+                return 1;
+            }
+        }
+        // Keep the catalog in ID order; paging and jump-to-ID rely on it
+        if (!is_sorted(stocks.begin(), stocks.end(), [](const Stock& a, const Stock& b) { return a.getId() < b.getId(); })) {
+            sort(stocks.begin(), stocks.end(), [](const Stock& a, const Stock& b) { return a.getId() < b.getId(); });
+        }
+        {
+            Trace::Span span("open_stores");
+            checkoutEngine.load(stocks);
+            stockAlerts.open("data/alerts.log", stocks);
+            carts.load("data/carts.log");
+        }
+        Metrics::startPeriodicExport("data/metrics.prom", METRICS_EXPORT_SECONDS);
+        startupSpan.stop();
 
         displayMainMenu();
+        // Make queued saves durable while the console can still show a failure
+        bool allSaved = Durability::flush();
+        displaySaveErrors();
+        if (!allSaved) {
+            return 1;
+        }
     } catch (const exception& e) {
+        cerr << "Cannot start: " << e.what() << endl;
         return 1;
     }
 
@@ -190,21 +335,8 @@ int main() {
 
 // ─── Main Menu ──────────────────────────────────────────────────
 void displayMainMenu() {
-    system("cls");
-    // Dynamic centering setup
-    const int tableWidth = 82;     // inside width of box
-    const int terminalWidth = 164; // adjust for your terminal width
-    int leftPadding = (terminalWidth - (tableWidth + 4)) / 2; // +4 for borders
-
-    auto padLeft = [&](const string& text) {
-        return string(leftPadding, ' ') + text;
-    };
-    
-    auto centerText = [&](const string& text) {
-        int spacesLeft = (tableWidth - text.size()) / 2;
-        int spacesRight = tableWidth - text.size() - spacesLeft;
-        return string(spacesLeft, ' ') + text + string(spacesRight, ' ');
-    };
+    ScreenRenderer::clearScreen();
+
      vector<string> lines = {
         "                                                      _    _      _                            _____                    ",
         "                                                     | |  | |    | |                          |_   _|                   ",
@@ -282,7 +414,7 @@ void displayMainMenu() {
                     Sleep(50); // Use usleep(300000) for Linux/Mac
                 } 
                 
-                // system("cls"); // Uncomment if you want to clear
+                // ScreenRenderer::clearScreen(); // Uncomment if you want to clear
                 adminLogin();
                 break;
             }
@@ -295,7 +427,7 @@ void displayMainMenu() {
                     Sleep(50); // Use usleep(300000) for Linux/Mac
                 }
                 
-                // system("cls"); // Uncomment if you want to clear
+                // ScreenRenderer::clearScreen(); // Uncomment if you want to clear
                 userLogin(); // just add add to allow user login or registration
                 break;
             }
@@ -320,24 +452,13 @@ void displayMainMenu() {
 void SetColor(int color); // Function prototype
 
 void SetColor(int color) {
+    ScreenRenderer::present(); // text already drawn keeps its colour
     HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
     SetConsoleTextAttribute(hConsole, color);
 }
 
 void loadingAnimation() {
-    const int tableWidth = 82;     // inside width of box
-    const int terminalWidth = 164; // adjust for your terminal width
-    int leftPadding = (terminalWidth - (tableWidth + 4)) / 2; // +4 for borders
 
-    auto padLeft = [&](const string& text) {
-        return string(leftPadding, ' ') + text;
-    };
-    
-    auto centerText = [&](const string& text) {
-        int spacesLeft = (tableWidth - text.size()) / 2;
-        int spacesRight = tableWidth - text.size() - spacesLeft;
-        return string(spacesLeft, ' ') + text + string(spacesRight, ' ');
-    };
     const int barWidth = 30;
     // Show starting message
     // Animation loop
@@ -366,22 +487,8 @@ void loadingAnimation() {
 }
 
 void backupStockDataWithCSV() {
-    system("cls");
-    
-    // Dynamic centering setup
-    const int tableWidth = 82;     // inside width of box
-    const int terminalWidth = 164; // adjust for your terminal width
-    int leftPadding = (terminalWidth - (tableWidth + 4)) / 2; // +4 for borders
-
-    auto padLeft = [&](const string& text) {
-        return string(leftPadding, ' ') + text;
-    };
+    ScreenRenderer::clearScreen();
     
-    auto centerText = [&](const string& text) {
-        int spacesLeft = (tableWidth - text.size()) / 2;
-        int spacesRight = tableWidth - text.size() - spacesLeft;
-        return string(spacesLeft, ' ') + text + string(spacesRight, ' ');
-    };
 
     // cout << "\033[35m\033[1m"; // Magenta and bold
     // cout << padLeft(" ____             _                 ____        _        ") << "\n";
@@ -470,7 +577,11 @@ void backupStockDataWithCSV() {
         cout << "\b\b\b\b\b\b\b\b";  // Move cursor back again to the start  
         cout << "\n";
         string backupFile = backupDir + "/stock_backup_" + buf + ".xlsx";
-        ExcelUtil::writeStockToFile(backupFile, stocks);
+        {
+            Metrics::ScopedTimer timer("backup_xlsx");
+            Trace::Span span("backup_xlsx", "backup");
+            ExcelUtil::writeStockToFile(backupFile, stocks);
+        }
         
         cout << padLeft("\033[92m✅ Excel backup created: ") << "stock_backup_" << buf << ".xlsx\033[0m\n";
 
@@ -486,6 +597,8 @@ void backupStockDataWithCSV() {
         cout << "\b\b\b\b\b\b\b\b";  // Move cursor back again to the start  
         cout << "\n";
         string csvBackupFile = backupDir + "/stock_backup_" + buf + ".csv";
+        Metrics::ScopedTimer csvTimer("backup_csv");
+        Trace::Span csvSpan("backup_csv", "backup");
         ofstream csvFile(csvBackupFile);
         
         if (csvFile.is_open()) {
@@ -500,10 +613,12 @@ void backupStockDataWithCSV() {
                 csvFile << stock.getId() << ","
                        << "\"" << stock.getName() << "\"," 
                        << stock.getQuantity() << ","
-                       << fixed << setprecision(2) << stock.getPrice() << "\n";
+                       << stock.getPrice().toString() << "\n";
                 processed++;
             }
             csvFile.close();
+            csvTimer.stop();
+            csvSpan.stop();
             
             cout << padLeft("\033[92m✅ CSV backup created: ") << "stock_backup_" << buf << ".csv\033[0m\n";
             cout << padLeft("\033[94m📈 Records processed: ") << totalItems << " items\033[0m\n";
@@ -511,6 +626,15 @@ void backupStockDataWithCSV() {
             throw runtime_error("Could not create CSV backup file");
         }
 
+        // Step 5: Receipt history as a spreadsheet; the live copy is the columnar store
+        cout << "\n" << padLeft("\033[96m🧾 Step 5: Exporting transactions (.xlsx)") << "\n";
+        {
+            Metrics::ScopedTimer timer("backup_transactions");
+            Trace::Span span("backup_transactions", "backup");
+            ExcelUtil::writeTransactionsToFile(backupDir + "/transactions_backup_" + buf + ".xlsx", receipts);
+        }
+        cout << padLeft("\033[92m✅ Transactions exported: ") << "transactions_backup_" << buf << ".xlsx\033[0m\n";
+
         // Final processing
         cout << "\n" << padLeft("\033[96m🔄 Finalizing backup process");
         for(int i = 0; i < 3; i++) {
@@ -532,30 +656,30 @@ void backupStockDataWithCSV() {
         cout << padLeft("║") << "\033[95m" << centerText("📋 BACKUP SUMMARY REPORT") << "\033[92m" << "  ║\n";
         cout << padLeft("║") << centerText("") << "║\n";
         cout << padLeft("║         ") << "\033[96m" << "📂 Backup Directory:" << "\033[97m" << string(53, ' ') << "\033[92m║\n";
-        cout << padLeft("\033[92m║          ") << "\033[94m" << "└─ " + backupDir + "/" << "\033[92m" << string(tableWidth - 13 - backupDir.length() - 1, ' ') << "║\n";
+        cout << padLeft("\033[92m║          ") << "\033[94m" << "└─ " + backupDir + "/" << "\033[92m" << string(Layout::TABLE_WIDTH - 13 - backupDir.length() - 1, ' ') << "║\n";
         cout << padLeft("║") << centerText("") << "║\n";
         cout << padLeft("║         ") << "\033[96m" << "📊 Excel File (.xlsx):" << "\033[97m" << string(51, ' ') << "\033[92m║\n";
-        cout << padLeft("\033[92m║          ") << "\033[94m" << "└─ stock_backup_" + string(buf) + ".xlsx" << "\033[92m" << string(tableWidth - 18 - 13 - strlen(buf), ' ') << "║\n";
+        cout << padLeft("\033[92m║          ") << "\033[94m" << "└─ stock_backup_" + string(buf) + ".xlsx" << "\033[92m" << string(Layout::TABLE_WIDTH - 18 - 13 - strlen(buf), ' ') << "║\n";
         cout << padLeft("║") << centerText("") << "║\n";
         cout << padLeft("║         ") << "\033[96m" << "📋 CSV File (.csv):" << "\033[97m" << string(54, ' ') << "\033[92m║\n";
-        cout << padLeft("\033[92m║          ") << "\033[94m" << "└─ stock_backup_" + string(buf) + ".csv" << "\033[92m" << string(tableWidth - 18 - 12 - strlen(buf), ' ') << "║\n";
+        cout << padLeft("\033[92m║          ") << "\033[94m" << "└─ stock_backup_" + string(buf) + ".csv" << "\033[92m" << string(Layout::TABLE_WIDTH - 18 - 12 - strlen(buf), ' ') << "║\n";
         cout << padLeft("║") << centerText("") << "║\n";
         cout << padLeft("║          ") << "\033[96m" << "📈 Backup Statistics:" << "\033[97m" << string(51, ' ') << "\033[92m║\n";
-        cout << padLeft("\033[92m║           ") << "\033[94m" << "└─ Total Items: " + to_string(stocks.size()) + " products" << "\033[92m" << string(tableWidth - 18 - 15 - to_string(stocks.size()).length() - 9, ' ') << "      ║\n";
+        cout << padLeft("\033[92m║           ") << "\033[94m" << "└─ Total Items: " + to_string(stocks.size()) + " products" << "\033[92m" << string(Layout::TABLE_WIDTH - 18 - 15 - to_string(stocks.size()).length() - 9, ' ') << "      ║\n";
         
         // Calculate total inventory value for summary
-        double totalValue = 0;
+        Money totalValue;
         int totalQuantity = 0;
         for (const auto& stock : stocks) {
             totalValue += stock.getPrice() * stock.getQuantity();
             totalQuantity += stock.getQuantity();
         }
         
-        cout << padLeft("║           ") << "\033[94m" << "└─ Total Quantity: " + to_string(totalQuantity) + " units" << "\033[92m" << string(tableWidth - 18 - 18 - to_string(totalQuantity).length() - 6, ' ') << "      ║\n";
-        cout << padLeft("║           ") << "\033[94m" << "└─ Total Value: $" + to_string((int)(totalValue * 100) / 100.0) << "\033[92m" << string(tableWidth - 18 - 15 - to_string((int)(totalValue * 100) / 100.0).length(), ' ') << "     ║\n";
+        cout << padLeft("║           ") << "\033[94m" << "└─ Total Quantity: " + to_string(totalQuantity) + " units" << "\033[92m" << string(Layout::TABLE_WIDTH - 18 - 18 - to_string(totalQuantity).length() - 6, ' ') << "      ║\n";
+        cout << padLeft("║           ") << "\033[94m" << "└─ Total Value: $" + totalValue.toString() << "\033[92m" << string(Layout::TABLE_WIDTH - 18 - 15 - totalValue.toString().length(), ' ') << "     ║\n";
         cout << padLeft("║") << centerText("") << "║\n";
         cout << padLeft("║         ") << "\033[96m" << "⏰ Backup Timestamp:" << "\033[97m" << string(53, ' ') << "\033[92m║\n";
-        cout << padLeft("\033[92m║           ") << "\033[94m" << "└─ " + string(readableBuf) << "\033[92m" << string(tableWidth - 14 - strlen(readableBuf), ' ') << "║\n";
+        cout << padLeft("\033[92m║           ") << "\033[94m" << "└─ " + string(readableBuf) << "\033[92m" << string(Layout::TABLE_WIDTH - 14 - strlen(readableBuf), ' ') << "║\n";
         cout << padLeft("║") << centerText("") << "║\n";
         cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
         cout << padLeft("║") << centerText("") << "║\n";
@@ -593,24 +717,10 @@ void backupStockDataWithCSV() {
 
 // ─── Admin Login ────────────────────────────────────────────────
 void adminLogin() {
-    system("cls");
+    ScreenRenderer::clearScreen();
     string username, password;
     SetColor(9);
 
-    // Dynamic centering setup
-    const int tableWidth = 82;     // inside width of box
-    const int terminalWidth = 164; // adjust for your terminal width
-    int leftPadding = (terminalWidth - (tableWidth + 4)) / 2; // +4 for borders
-
-    auto padLeft = [&](const string& text) {
-        return string(leftPadding, ' ') + text;
-    };
-    
-    auto centerText = [&](const string& text) {
-        int spacesLeft = (tableWidth - text.size()) / 2;
-        int spacesRight = tableWidth - text.size() - spacesLeft;
-        return string(spacesLeft, ' ') + text + string(spacesRight, ' ');
-    };
 
     cout << "\033[96m\033[1m";
     cout << "\n" << padLeft("╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
@@ -635,14 +745,16 @@ void adminLogin() {
     gotoxy(55, 10); // Adjust Y for Password line
     password = getPasswordInput("");
 
-    for (const auto& user : users) {
-        if (user.getUsername() == username && user.getPassword() == password && user.isAdmin()) {
-            gotoxy(55, 14);
-            cout << "\n" << padLeft("🔐 Authenticating credentials");
-            loadingAnimation();  // Show loading animation after successful login
-            adminDashboard();
-            return;
-        }
+    Metrics::ScopedTimer loginTimer("login");
+    int userPos = userIndex.find(username);
+    bool authenticated = userPos != UserIndex::NOT_FOUND && users[userPos].getPassword() == password && users[userPos].isAdmin();
+    loginTimer.stop();
+    if (authenticated) {
+        gotoxy(55, 14);
+        cout << "\n" << padLeft("🔐 Authenticating credentials");
+        loadingAnimation();  // Show loading animation after successful login
+        adminDashboard();
+        return;
     }
     
     // Error message with enhanced styling
@@ -661,23 +773,12 @@ void adminLogin() {
 
 // ─── Admin Dashboard ────────────────────────────────────────────
 void adminDashboard() {
-    system("cls");
-        const int tableWidth = 82;     // inside width of box
-    const int terminalWidth = 164; // adjust for your terminal width
-    int leftPadding = (terminalWidth - (tableWidth + 4)) / 2; // +4 for borders
+    ScreenRenderer::clearScreen();
 
-    auto padLeft = [&](const string& text) {
-        return string(leftPadding, ' ') + text;
-    };
-    
-    auto centerText = [&](const string& text) {
-        int spacesLeft = (tableWidth - text.size()) / 2;
-        int spacesRight = tableWidth - text.size() - spacesLeft;
-        return string(spacesLeft, ' ') + text + string(spacesRight, ' ');
-    };
     int choice;
     do {
-        system("cls");
+        displaySaveErrors();
+        ScreenRenderer::clearScreen();
         // Enhanced admin dashboard design with consistent styling
         cout << "\033[96m\033[1m";
         cout << "\n                                       ╔══════════════════════════════════════════════════════════════════════════════════╗\n";
@@ -713,7 +814,10 @@ void adminDashboard() {
         cout << "                                       ║         " << "\033[94m" << "[10] 👤❌ Delete User" << "\033[96m" << "                                                    ║\n";
         cout << "                                       ║             " << "\033[92m" << "└─ Remove user accounts from system" << "\033[96m" << "                                  ║\n";
         cout << "                                       ║                                                                                  ║\n";                                       
-        cout << "                                       ║         " << "\033[94m" << "[11] 🚪 Logout" << "\033[96m" << "                                                           ║\n";
+        cout << "                                       ║         " << "\033[94m" << "[11] 🧠 Memory Usage" << "\033[96m" << "                                                     ║\n";
+        cout << "                                       ║             " << "\033[92m" << "└─ Live and peak bytes per subsystem" << "\033[96m" << "                                 ║\n";
+        cout << "                                       ║                                                                                  ║\n";
+        cout << "                                       ║         " << "\033[94m" << "[12] 🚪 Logout" << "\033[96m" << "                                                           ║\n";
         cout << "                                       ║             " << "\033[92m" << "└─ Exit admin panel safely" << "\033[96m" << "                                           ║\n";
         cout << "                                       ║                                                                                  ║\n";
         cout << "                                       ╚══════════════════════════════════════════════════════════════════════════════════╝\n";
@@ -726,8 +830,8 @@ void adminDashboard() {
             cin.clear(); // clear fail state
             cin.ignore(numeric_limits<streamsize>::max(), '\n'); // discard bad input            
             // Enhanced error message
-            cout << "\n    " << "\033[91m" << "                                   ❌ Invalid input! Please enter a number between 1 and 11." << "\033[0m" << "\n";
-            _getch(); // wait for user to acknowledge
+            cout << "\n    " << "\033[91m" << "                                   ❌ Invalid input! Please enter a number between 1 and 12." << "\033[0m" << "\n";
+            readKey(); // wait for user to acknowledge
             continue; // skip to next loop iteration
         }
 
@@ -740,7 +844,7 @@ void adminDashboard() {
                     cout.flush();
                     Sleep(50); // Use usleep(300000) for Linux/Mac
                 }
-                system("cls");
+                ScreenRenderer::clearScreen();
                 addStock();
                 cout << "    " << "\033[93m" << "                                   📋 Press any key to go back to the menu..." << "\033[0m" << "\n";
                 gotoxy(81, 14); // Move cursor to a specific position 
@@ -759,7 +863,7 @@ void adminDashboard() {
                 cout << "\b\b\b\b\b\b\b\b";  // Go back 8 spaces (4 symbols × 2 bytes each)
                 cout << "        ";          // Print spaces to erase
                 cout << "\b\b\b\b\b\b\b\b";  // Move cursor back again to the start            
-                system("cls");
+                ScreenRenderer::clearScreen();
                 updateStock();
                 break;
             }
@@ -774,7 +878,7 @@ void adminDashboard() {
                 cout << "\b\b\b\b\b\b\b\b";  // Go back 8 spaces (4 symbols × 2 bytes each)
                 cout << "        ";          // Print spaces to erase
                 cout << "\b\b\b\b\b\b\b\b";  // Move cursor back again to the start                
-                system("cls");
+                ScreenRenderer::clearScreen();
                 deleteStock();
                 break;
             }
@@ -790,7 +894,7 @@ void adminDashboard() {
                 cout << "        ";          // Print spaces to erase
                 cout << "\b\b\b\b\b\b\b\b";  // Move cursor back again to the start
                 
-                system("cls");
+                ScreenRenderer::clearScreen();
                 searchStock();
                 // gotoxy(81, 14); // Move cursor to a specific position 
                 // cin.ignore(numeric_limits<streamsize>::max(), '\n');
@@ -809,12 +913,7 @@ void adminDashboard() {
                 cout << "        ";          // Print spaces to erase
                 cout << "\b\b\b\b\b\b\b\b";  // Move cursor back again to the start
                
-                system("cls");
                 displayAllStocks();
-                    // Interactive prompt
-                cout << "    " << "\033[93m" << "                                   📋 Press any key to go back to the menu..." << "\033[0m" << "\n";
-                gotoxy(81, 13); // Move cursor to a specific position 
-                _getch();
                 break;
             }
             case 6:{
@@ -828,7 +927,7 @@ void adminDashboard() {
                 cout << "\b\b\b\b\b\b\b\b";  // Go back 8 spaces (4 symbols × 2 bytes each)
                 cout << "        ";          // Print spaces to erase
                 cout << "\b\b\b\b\b\b\b\b";  // Move cursor back again to the start
-                system("cls");
+                ScreenRenderer::clearScreen();
                 trackInventory();
                 break;
             }
@@ -844,7 +943,7 @@ void adminDashboard() {
                 cout << "        ";          // Print spaces to erase
                 cout << "\b\b\b\b\b\b\b\b";  // Move cursor back again to the start
 
-                system("cls");
+                ScreenRenderer::clearScreen();
                 generateLowStockAlerts(); 
                 break;
             }
@@ -860,7 +959,7 @@ void adminDashboard() {
                 cout << "        ";          // Print spaces to erase
                 cout << "\b\b\b\b\b\b\b\b";  // Move cursor back again to the start
 
-                system("cls");
+                ScreenRenderer::clearScreen();
                 printStockReport();
                 break;  
             }
@@ -888,46 +987,37 @@ void adminDashboard() {
                 cout << "        ";          // Print spaces to erase
                 cout << "\b\b\b\b\b\b\b\b";  // Move cursor back again to the start
 
-                system("cls");
+                ScreenRenderer::clearScreen();
                 deleteUser(); // Call the new function
                 break;
             }
             case 11:{
-                system("cls");
+                ScreenRenderer::clearScreen();
+                displayMemoryUsage();
+                break;
+            }
+            case 12:{
+                ScreenRenderer::clearScreen();
                 currentUser = nullptr;
                 break;
             }
             default:
                 // Enhanced error for invalid choice
                 cout << "\n    " << "\033[91m\033[1m" << "                                   ⚠️  INVALID CHOICE!" << "\033[0m" << "\n";
-                cout << "    " << "\033[93m" << "                                   Please select a number between 1 and 11 only." << "\033[0m" << "\n";
-                _getch(); // Wait for user input
+                cout << "    " << "\033[93m" << "                                   Please select a number between 1 and 12 only." << "\033[0m" << "\n";
+                readKey(); // Wait for user input
                 break;
         }
-    } while (choice != 11);
+    } while (choice != 12);
 }
 
 // ─── Add Stock ──────────────────────────────────────────────────
 void addStock() {
-    system("cls");
+    ScreenRenderer::clearScreen();
     string name;
     int quantity;
     double price;
 
-    // Dynamic centering setup
-    const int tableWidth = 82;     // inside width of box
-    const int terminalWidth = 164; // adjust for your terminal width
-    int leftPadding = (terminalWidth - (tableWidth + 4)) / 2; // +4 for borders
-
-    auto padLeft = [&](const string& text) {
-        return string(leftPadding, ' ') + text;
-    };
-    
-    auto centerText = [&](const string& text) {
-        int spacesLeft = (tableWidth - text.size()) / 2;
-        int spacesRight = tableWidth - text.size() - spacesLeft;
-        return string(spacesLeft, ' ') + text + string(spacesRight, ' ');
-    };
 
     // ASCII Art Header
     cout << "\033[34m"; // Blue
@@ -998,8 +1088,14 @@ void addStock() {
     cout << "\b\b\b\b\b\b\b\b";  // Move cursor back again to the start
 
     int newId = ExcelUtil::getNextStockId(stocks);
-    stocks.emplace_back(newId, name, quantity, price);
-    ExcelUtil::writeStockToFile("data/stock.xlsx", stocks);
+    Stock added(newId, name, quantity, Money::fromDouble(price));
+    if (!stockDb.put(added)) {
+        displayCatalogWriteError("Product was not added");
+        return;
+    }
+    stocks.push_back(added);
+    checkoutEngine.setQuantity(newId, quantity);
+    stockAlerts.onAdded(stocks.back());
 
     // Success message
     cout << "\n" << padLeft("\033[92m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
@@ -1013,24 +1109,10 @@ void addStock() {
 }
 // ─── Update Stock ───────────────────────────────────────────────
 void updateStock() {
-    system("cls");
+    ScreenRenderer::clearScreen();
     int id;
     int choice;
     
-    // Dynamic centering setup
-    const int tableWidth = 82;     // inside width of box
-    const int terminalWidth = 164; // adjust for your terminal width
-    int leftPadding = (terminalWidth - (tableWidth + 4)) / 2; // +4 for borders
-
-    auto padLeft = [&](const string& text) {
-        return string(leftPadding, ' ') + text;
-    };
-    
-    auto centerText = [&](const string& text) {
-        int spacesLeft = (tableWidth - text.size()) / 2;
-        int spacesRight = tableWidth - text.size() - spacesLeft;
-        return string(spacesLeft, ' ') + text + string(spacesRight, ' ');
-    };
 
     string asciiArt[] = {
         " _    _           _       _          _____ _             _    ",
@@ -1045,7 +1127,7 @@ void updateStock() {
 
     cout << "\n";
     for (const string& line : asciiArt) {
-        cout << padLeft(" " + centerText(line) + " ") << endl;
+        cout << padLeft(" ") << centerText(line) << " \n";
     }
     cout << "\n";
     // Enhanced update stock design with dynamic centering
@@ -1079,7 +1161,7 @@ void updateStock() {
         cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\n";
         cout << "\n" << padLeft("\033[93m⚠️  Press any key to try again...\033[0m") << "\n";
         gotoxy(72, 30); // Move cursor to a specific position
-        _getch(); // Wait for user input
+        readKey(); // Wait for user input
         return;
     }
     // Find the stock item by ID
@@ -1088,12 +1170,13 @@ void updateStock() {
     });
 
     if (it != stocks.end()) {
+        Stock original = *it; // restored if the catalog file rejects the change
         // Product found - show options menu
         gotoxy(64, 24); // Move cursor to a specific position
         cout << "\n" << padLeft("\033[92m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
         cout << padLeft("║") << "\033[93m" << centerText("✅ PRODUCT FOUND!") << "\033[92m" << " ║\n";
-        printf("%s║%s              Product: %-25s    %s                              ║%s\n", 
-            string(leftPadding, ' ').c_str(), "\033[96m", 
+        ScreenRenderer::printf("%s║%s              Product: %-25s    %s                              ║%s\n", 
+            Layout::margin(), "\033[96m", 
             it->getName().length() > 25 ? (it->getName().substr(0, 22) + "...").c_str() : it->getName().c_str(), 
             "\033[92m", "\033[0m");
         cout << padLeft("\033[92m╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
@@ -1114,6 +1197,9 @@ void updateStock() {
         cout << padLeft("║         ") << "\033[94m" << "[3] 💰 Update Price" << "\033[96m" << string(54, ' ') << "║\n";
         cout << padLeft("║             ") << "\033[92m" << "└─ Change the unit price" << "\033[96m" << string(45, ' ') << "║\n";
         cout << padLeft("║") << centerText("") << "║\n";
+        cout << padLeft("║         ") << "\033[94m" << "[4] 🚨 Update Reorder Threshold" << "\033[96m" << string(42, ' ') << "║\n";
+        cout << padLeft("║             ") << "\033[92m" << "└─ Set the low-stock alert level" << "\033[96m" << string(37, ' ') << "║\n";
+        cout << padLeft("║") << centerText("") << "║\n";
         cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\n";
         cout << "\033[0m";
 
@@ -1127,12 +1213,13 @@ void updateStock() {
         string newName;
         int newQuantity;
         double newPrice;
+        int newThreshold;
 
         bool updateName = false, updateQuantity = false, updatePrice = false;
 
         switch (choice) {
             case 1: {
-                system("cls");
+                ScreenRenderer::clearScreen();
                 cout << "\n" << padLeft("\033[96m\033[1m") << "\n";
                 cout << padLeft("╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
                 cout << padLeft("║") << "\033[93m" << centerText("📝 UPDATE PRODUCT NAME") << "\033[96m" << "  ║\n";
@@ -1155,7 +1242,7 @@ void updateStock() {
                 }
             }
             case 2: {
-                system("cls");
+                ScreenRenderer::clearScreen();
                 cout << "\n" << padLeft("\033[96m\033[1m") << "\n";
                 cout << padLeft("╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
                 cout << padLeft("║") << "\033[93m" << centerText("📊 UPDATE QUANTITY") << "\033[96m" << "  ║\n";
@@ -1167,7 +1254,10 @@ void updateStock() {
                     cin.ignore(numeric_limits<streamsize>::max(), '\n');
                     cout << padLeft("\033[91m❌ Invalid input! Quantity must be a positive number ▶ \033[0m");
                 }
+                int oldQuantity = it->getQuantity();
                 it->setQuantity(newQuantity);
+                checkoutEngine.setQuantity(it->getId(), newQuantity);
+                stockAlerts.onQuantityChange(*it, oldQuantity);
                 updateQuantity = true;
 
                 // Ask for price
@@ -1181,7 +1271,7 @@ void updateStock() {
                 }
             }
             case 3: {
-                system("cls");
+                ScreenRenderer::clearScreen();
                 cout << "\n" << padLeft("\033[96m\033[1m") << "\n";
                 cout << padLeft("╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
                 cout << padLeft("║") << "\033[93m" << centerText("💰 UPDATE PRICE") << "\033[96m" << "  ║\n";
@@ -1193,13 +1283,32 @@ void updateStock() {
                     cin.ignore(numeric_limits<streamsize>::max(), '\n');
                     cout << padLeft("\033[91m❌ Invalid input! Price must be a positive number ▶ \033[0m");
                 }
-                it->setPrice(newPrice);
+                it->setPrice(Money::fromDouble(newPrice));
                 updatePrice = true;
                 break;
             }
+            case 4: {
+                ScreenRenderer::clearScreen();
+                cout << "\n" << padLeft("\033[96m\033[1m") << "\n";
+                cout << padLeft("╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
+                cout << padLeft("║") << "\033[93m" << centerText("🚨 UPDATE REORDER THRESHOLD") << "\033[96m" << "  ║\n";
+                cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
+
+                cout << "\n" << padLeft("\033[97mCurrent threshold: " + to_string(it->getReorderThreshold()) + "\033[0m") << "\n";
+                cout << "\n" << padLeft("\033[92m\033[1m🚨 Enter new threshold ▶ \033[0m");
+                while (!(cin >> newThreshold) || newThreshold < 0) {
+                    cin.clear();
+                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                    cout << padLeft("\033[91m❌ Invalid input! Threshold must be a positive number ▶ \033[0m");
+                }
+                int oldThreshold = it->getReorderThreshold();
+                it->setReorderThreshold(newThreshold);
+                stockAlerts.onThresholdChange(*it, oldThreshold);
+                break;
+            }
             default: {
                 gotoxy(0, 39); // Move cursor to a specific position
-                cout << "\n" << padLeft("\033[91m❌ Invalid choice! Please enter a number between 1 and 3.\033[0m") << "\n";
+                cout << "\n" << padLeft("\033[91m❌ Invalid choice! Please enter a number between 1 and 4.\033[0m") << "\n";
                 cout << padLeft("\033[93m⚠️  Press any key to go back to the menu...\033[0m") << "\n";
                 cin.ignore(numeric_limits<streamsize>::max(), '\n');
                 cin.get();
@@ -1209,7 +1318,19 @@ void updateStock() {
 
 
         // Processing animation        
-        ExcelUtil::writeStockToFile("data/stock.xlsx", stocks);      
+        if (!stockDb.put(*it)) {
+            // Put the product back the way the catalog file still has it
+            int failedQuantity = it->getQuantity();
+            int failedThreshold = it->getReorderThreshold();
+            *it = original;
+            checkoutEngine.setQuantity(it->getId(), it->getQuantity());
+            stockAlerts.onQuantityChange(*it, failedQuantity);
+            stockAlerts.onThresholdChange(*it, failedThreshold);
+            displayCatalogWriteError("Product was not updated");
+            cout << "\n" << padLeft("\033[93m⚠️  Press any key to go back to the menu...\033[0m") << "\n";
+            readKey(); // wait for user input
+            return;
+        }
         // Success message
         cout << padLeft("\033[92m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
         cout << padLeft("║") << "\033[93m" << centerText("✅ UPDATE SUCCESSFUL!") << "\033[92m" << " ║" << "\n";
@@ -1217,43 +1338,30 @@ void updateStock() {
         cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
         cout << "\n" << padLeft("\033[93m⚠️  Press any key to go back to the menu...\033[0m") << "\n";
         gotoxy(72, 19); // Move cursor to a specific position
-        _getch(); // wait for user input
+        readKey(); // wait for user input
         return; // exit updateStock and go back to menu
     } else {
         // Product not found
         gotoxy(0, 17); 
         cout << padLeft("\033[93m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
         cout << padLeft("║\033[93m") << centerText("❌ NOT FOUND!") << "\033[93m ║\n"; 
-        printf("%s║%s                            Product ID %3d not found                %s              \033[93m║%s\n",
-            string(leftPadding, ' ').c_str(), "\033[96m", id, "\033[91m", "\033[0m");
+        ScreenRenderer::printf("%s║%s                            Product ID %3d not found                %s              \033[93m║%s\n",
+            Layout::margin(), "\033[96m", id, "\033[91m", "\033[0m");
         cout << padLeft("\033[93m║") << "\033[94m" << centerText("Please check the ID and try again") << "\033[93m║\n";
         cout << padLeft("\033[93m╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
         cout << "\n" << padLeft("\033[93m⚠️  Press any key to go back to the menu...\033[0m") << "\n";
         gotoxy(82, 23); // Move cursor to a specific position
-        _getch(); // wait for user input
+        readKey(); // wait for user input
     }
 }
 
 // ─── Delete Stock ───────────────────────────────────────────────
 void deleteStock() {
-    system("cls");
+    size_t catalogPage = browseStocks(0); // let the admin find the ID first
+    ScreenRenderer::clearScreen();
     int id;
     char confirmation;
     
-    // Dynamic centering setup
-    const int tableWidth = 82;     // inside width of box
-    const int terminalWidth = 164; // adjust for your terminal width
-    int leftPadding = (terminalWidth - (tableWidth + 4)) / 2; // +4 for borders
-
-    auto padLeft = [&](const string& text) {
-        return string(leftPadding, ' ') + text;
-    };
-    
-    auto centerText = [&](const string& text) {
-        int spacesLeft = (tableWidth - text.size()) / 2;
-        int spacesRight = tableWidth - text.size() - spacesLeft;
-        return string(spacesLeft, ' ') + text + string(spacesRight, ' ');
-    };
 
     // ASCII Art Header
     cout << "\033[34m"; // Blue
@@ -1265,7 +1373,8 @@ void deleteStock() {
 
     SetColor(9);
 
-    displayAllStocks(); 
+    int catalogLines = DisplayUtil::displayStocks(stocks, catalogPage);
+    const int formTop = 5 + catalogLines; // screen row of the form's top border
     // Enhanced delete stock design with dynamic centering
     cout << "\033[96m\033[1m";
     cout << "\n" << padLeft("╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
@@ -1285,23 +1394,23 @@ void deleteStock() {
     // Enhanced input prompt2
     // gotoxy(63,30); 
     // cout << "\n" << padLeft("\033[95m\033[1m💭 Enter Product ID ▶ \033[0m");
-    gotoxy(92,27);
+    gotoxy(92, formTop + 9);
     cin >> id;
 
     if(cin.fail()) {
         cin.clear(); // clear fail state
         cin.ignore(numeric_limits<streamsize>::max(), '\n'); // discard bad input
-        gotoxy(55, 31); // Move cursor to a specific position
+        gotoxy(55, formTop + 13); // Move cursor to a specific position
         cout << "\n" << padLeft("\033[91m❌ Invalid input! Please enter a numeric ID.\033[0m") << "\n";
         cout << padLeft("\033[93m📋 Press any key to go back to the menu...\033[0m") << "\n";
-        _getch(); // wait for user input
+        readKey(); // wait for user input
         cout << "\b\b\b\b\b\b\b\b";  // Go back 8 spaces (4 symbols × 2 bytes each)
         cout << "        ";          // Print spaces to erase
         cout << "\b\b\b\b\b\b\b\b";  // Move cursor back again to the start  
         return; // exit deleteStock and go back to menu
     }
     // Search animation 
-    gotoxy(0, 30);
+    gotoxy(0, formTop + 12);
     cout << "\n" << padLeft("\033[96m🔍 Searching for product");
     for(int i = 0; i < 3; i++) {
         cout << " ▓";
@@ -1323,12 +1432,12 @@ void deleteStock() {
         cout << padLeft("║") << "\033[91m" << centerText("⚠️  PRODUCT FOUND!") << "\033[93m" << "     ║" << "\n";
         cout << padLeft("║") << "\033[96m" << centerText("This product will be deleted:") << "\033[93m" << "║" << "\n";
         cout << padLeft("║") << centerText("") << "║\n";
-        printf("%s\033[93m║%s                             ID: %3d  │  Name: %-25s      %s    ║%s\n", 
-               string(leftPadding, ' ').c_str(), "\033[94m", it->getId(),
+        ScreenRenderer::printf("%s\033[93m║%s                             ID: %3d  │  Name: %-25s      %s    ║%s\n", 
+               Layout::margin(), "\033[94m", it->getId(),
                it->getName().length() > 25 ? (it->getName().substr(0, 22) + "...").c_str() : it->getName().c_str(),
                "\033[93m", "\033[0m");
-        printf("%s\033[93m║%s                       Quantity: %4d │  Price: $%-8.2f                   %s      ║%s\n", 
-               string(leftPadding, ' ').c_str(), "\033[94m", it->getQuantity(), it->getPrice(),
+        ScreenRenderer::printf("%s\033[93m║%s                       Quantity: %4d │  Price: $%-8s                   %s      ║%s\n", 
+               Layout::margin(), "\033[94m", it->getQuantity(), it->getPrice().toString().c_str(),
                "\033[93m", "\033[0m");
         cout << padLeft("\033[93m╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
 
@@ -1363,14 +1472,21 @@ void deleteStock() {
             cout << "\b\b\b\b\b\b\b\b";  // Go back 8 spaces (4 symbols × 2 bytes each)
             cout << "        ";          // Print spaces to erase
             cout << "\b\b\b\b\b\b\b\b";  // Move cursor back again to the start
+            if (!stockDb.erase(it->getId())) {
+                displayCatalogWriteError("Product was not deleted");
+                cout << padLeft("\033[93m📋 Press any key to go back to the menu...\033[0m") << "\n";
+                readKey(); // wait for user input
+                return;
+            }
+            checkoutEngine.removeSku(it->getId());
+            stockAlerts.onRemoved(it->getId());
             stocks.erase(it);
-            ExcelUtil::writeStockToFile("data/stock.xlsx", stocks);
         
             cout << "\n" << padLeft("\033[91m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
             cout << padLeft("║") << "\033[93m" << centerText ( "✅ DELETION SUCCESSFUL!") << "\033[91m" << " ║" << "\n";
             cout << padLeft("║") << "\033[96m" << centerText ("Product has been removed from inventory") << "\033[91m" << "║" << "\n";
-            printf("%s║%s                                 Product ID: %3d                    %s              ║%s\n", 
-                   string(leftPadding, ' ').c_str(), "\033[94m", id, "\033[91m", "\033[0m");
+            ScreenRenderer::printf("%s║%s                                 Product ID: %3d                    %s              ║%s\n", 
+                   Layout::margin(), "\033[94m", id, "\033[91m", "\033[0m");
             cout << padLeft("\033[91m╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
             // cout << padLeft("\033[93m📋 Press any key to go back to the menu...\033[0m") << "\n";
             // cin.get();
@@ -1386,34 +1502,20 @@ void deleteStock() {
         // Product not found
         cout << "\n" << padLeft("\033[91m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
         cout << padLeft("║") << "\033[93m" <<centerText ( "❌ NOT FOUND!") << "\033[91m" << " ║" << "\n";
-        printf("%s║%s                              Product ID %3d not found                %s            ║%s\n", 
-               string(leftPadding, ' ').c_str(), "\033[96m", id, "\033[91m", "\033[0m");
+        ScreenRenderer::printf("%s║%s                              Product ID %3d not found                %s            ║%s\n", 
+               Layout::margin(), "\033[96m", id, "\033[91m", "\033[0m");
         cout << padLeft("\033[91m║") << "\033[94m" << centerText ("Please check the ID and try again") << "\033[91m" << "║" << "\n";
         cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
     }
     cout << padLeft("\033[93m📋 Press any key to go back to the menu...\033[0m") << "\n";
-    _getch(); // wait for user input 
+    readKey(); // wait for user input 
 
 }
 // ─── Search Stock ───────────────────────────────────────────────
 void searchStock() {
-    system("cls");
+    ScreenRenderer::clearScreen();
     int id;
     
-    // Dynamic centering setup
-    const int tableWidth = 82;     // inside width of box
-    const int terminalWidth = 164; // adjust for your terminal width
-    int leftPadding = (terminalWidth - (tableWidth + 4)) / 2; // +4 for borders
-
-    auto padLeft = [&](const string& text) {
-        return string(leftPadding, ' ') + text;
-    };
-    
-    auto centerText = [&](const string& text) {
-        int spacesLeft = (tableWidth - text.size()) / 2;
-        int spacesRight = tableWidth - text.size() - spacesLeft;
-        return string(spacesLeft, ' ') + text + string(spacesRight, ' ');
-    };
 
     // ASCII Art Header
     cout << "\033[34m";  // Blue
@@ -1451,6 +1553,7 @@ void searchStock() {
     }
     // Search animation
     gotoxy(64,17);
+    checkoutEngine.expireReservations(); // drop holds of abandoned carts
     cout << "\n" << padLeft("\033[96m🔍 Searching inventory");
     for(int i = 0; i < 4; i++) {
         cout << " ▓";
@@ -1463,68 +1566,70 @@ void searchStock() {
 
 
     
-    bool found = false;
-    for (const auto& s : stocks) {
-        if (s.getId() == id) {
-            // Product found - display detailed information
-            cout << "\n" << padLeft("\033[92m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
-            cout << padLeft("║") << "\033[93m" << centerText("✅ PRODUCT FOUND!") << "\033[92m" << " ║" << "\n";
-            cout << padLeft("║") << "\033[96m" << centerText("Product details displayed below:") << "\033[92m" << "║" << "\n";
-            cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
-
-            // Product details table
-            cout << "\033[96m\033[1m";
-            cout << "\n" << padLeft("╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
-            cout << padLeft("║") << "\033[93m" << centerText("📋 PRODUCT DETAILS") << "\033[96m" << "  ║\n";
-            cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
-            cout << padLeft("║") << centerText("") << "║\n";
-            
-            printf("%s║%s         🆔 Product ID: %-3d                                    %s                   ║%s\n", 
-                   string(leftPadding, ' ').c_str(), "\033[94m", s.getId(), "\033[96m", "\033[0m");
-            cout << padLeft("\033[96m\033[1m║") << centerText("") << "║\n";
-            
-            printf("%s║%s         📦 Product Name: %-35s    %s                 ║%s\n", 
-                   string(leftPadding, ' ').c_str(), "\033[94m", 
-                   s.getName().length() > 35 ? (s.getName().substr(0, 32) + "...").c_str() : s.getName().c_str(), 
-                   "\033[96m", "\033[0m");
-            cout << padLeft("\033[96m\033[1m║") << centerText("") << "║\n";
-            
-            printf("%s\033[96m\033[1m║%s         📊 Stock Quantity: %-6d                            %s                    ║%s\n", 
-                   string(leftPadding, ' ').c_str(), "\033[94m", s.getQuantity(), "\033[96m", "\033[0m");
-            cout << padLeft("\033[96m\033[1m║") << centerText("") << "║\n";
-            
-            printf("%s\033[96m\033[1m║%s         💰 Unit Price: $%-8.2f                            %s                     ║%s\n", 
-                   string(leftPadding, ' ').c_str(), "\033[94m", s.getPrice(), "\033[96m", "\033[0m");
-            cout << padLeft("\033[96m\033[1m║") << centerText("") << "║\n";
-            
-            printf("%s\033[96m\033[1m║%s         💵 Total Value: $%-8.2f                           %s                     ║%s\n", 
-                   string(leftPadding, ' ').c_str(), "\033[94m", (s.getPrice() * s.getQuantity()), "\033[96m", "\033[0m");
-            cout << padLeft("\033[96m\033[1m║") << centerText("") << "║\n";
-            
-            // Stock status indicator
-            string stockStatus;
-            string statusColor;
-            if (s.getQuantity() == 0) {
-                stockStatus = "⚠️  OUT OF STOCK";
-                statusColor = "\033[91m"; // Red
-            } else if (s.getQuantity() < 10) {
-                stockStatus = "⚠️  LOW STOCK";
-                statusColor = "\033[93m"; // Yellow
-            } else {
-                stockStatus = "✅ IN STOCK";
-                statusColor = "\033[92m"; // Green
-            }
-            
-            printf("%s\033[96m\033[1m║%s         📈 Stock Status: %s%-15s%s                 %s                         ║%s\n", 
-                   string(leftPadding, ' ').c_str(), "\033[94m", statusColor.c_str(), stockStatus.c_str(), 
-                   "\033[94m", "\033[96m", "\033[0m");
-            cout << padLeft("\033[96m\033[1m║") << centerText("") << "║\n";
-            cout << padLeft("\033[96m\033[1m╚══════════════════════════════════════════════════════════════════════════════════╝") << "\n";
-            cout << "\033[0m";
+    const Stock* match = findStockById(id);
+    bool found = match != nullptr;
+    if (found) {
+        const Stock& s = *match;
+        // Product found - display detailed information
+        cout << "\n" << padLeft("\033[92m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
+        cout << padLeft("║") << "\033[93m" << centerText("✅ PRODUCT FOUND!") << "\033[92m" << " ║" << "\n";
+        cout << padLeft("║") << "\033[96m" << centerText("Product details displayed below:") << "\033[92m" << "║" << "\n";
+        cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
 
-            found = true;
-            break; // Since ID is unique, break early
+        // Product details table
+        cout << "\033[96m\033[1m";
+        cout << "\n" << padLeft("╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
+        cout << padLeft("║") << "\033[93m" << centerText("📋 PRODUCT DETAILS") << "\033[96m" << "  ║\n";
+        cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
+        cout << padLeft("║") << centerText("") << "║\n";
+        
+        ScreenRenderer::printf("%s║%s         🆔 Product ID: %-3d                                    %s                   ║%s\n", 
+               Layout::margin(), "\033[94m", s.getId(), "\033[96m", "\033[0m");
+        cout << padLeft("\033[96m\033[1m║") << centerText("") << "║\n";
+        
+        ScreenRenderer::printf("%s║%s         📦 Product Name: %-35s    %s                 ║%s\n", 
+               Layout::margin(), "\033[94m", 
+               s.getName().length() > 35 ? (s.getName().substr(0, 32) + "...").c_str() : s.getName().c_str(), 
+               "\033[96m", "\033[0m");
+        cout << padLeft("\033[96m\033[1m║") << centerText("") << "║\n";
+        
+        ScreenRenderer::printf("%s\033[96m\033[1m║%s         📊 Stock Quantity: %-6d                            %s                    ║%s\n", 
+               Layout::margin(), "\033[94m", s.getQuantity(), "\033[96m", "\033[0m");
+        cout << padLeft("\033[96m\033[1m║") << centerText("") << "║\n";
+
+        ScreenRenderer::printf("%s\033[96m\033[1m║%s         🛒 Available: %-6d │ Reserved: %-6d             %s                    ║%s\n", 
+               Layout::margin(), "\033[94m", checkoutEngine.getAvailable(s.getId()),
+               checkoutEngine.getReserved(s.getId()), "\033[96m", "\033[0m");
+        cout << padLeft("\033[96m\033[1m║") << centerText("") << "║\n";
+        
+        ScreenRenderer::printf("%s\033[96m\033[1m║%s         💰 Unit Price: $%-8s                            %s                     ║%s\n", 
+               Layout::margin(), "\033[94m", s.getPrice().toString().c_str(), "\033[96m", "\033[0m");
+        cout << padLeft("\033[96m\033[1m║") << centerText("") << "║\n";
+        
+        ScreenRenderer::printf("%s\033[96m\033[1m║%s         💵 Total Value: $%-8s                           %s                     ║%s\n", 
+               Layout::margin(), "\033[94m", (s.getPrice() * s.getQuantity()).toString().c_str(), "\033[96m", "\033[0m");
+        cout << padLeft("\033[96m\033[1m║") << centerText("") << "║\n";
+        
+        // Stock status indicator
+        string stockStatus;
+        string statusColor;
+        if (s.getQuantity() == 0) {
+            stockStatus = "⚠️  OUT OF STOCK";
+            statusColor = "\033[91m"; // Red
+        } else if (s.getQuantity() < 10) {
+            stockStatus = "⚠️  LOW STOCK";
+            statusColor = "\033[93m"; // Yellow
+        } else {
+            stockStatus = "✅ IN STOCK";
+            statusColor = "\033[92m"; // Green
         }
+        
+        ScreenRenderer::printf("%s\033[96m\033[1m║%s         📈 Stock Status: %s%-15s%s                 %s                         ║%s\n", 
+               Layout::margin(), "\033[94m", statusColor.c_str(), stockStatus.c_str(), 
+               "\033[94m", "\033[96m", "\033[0m");
+        cout << padLeft("\033[96m\033[1m║") << centerText("") << "║\n";
+        cout << padLeft("\033[96m\033[1m╚══════════════════════════════════════════════════════════════════════════════════╝") << "\n";
+        cout << "\033[0m";
     }
 
     if (!found) {
@@ -1552,31 +1657,67 @@ void searchStock() {
     }
     cout << padLeft("\033[93m📋 Press any key to go back to the menu...\033[0m") << "\n";
     gotoxy(83, 39); // Move cursor to a specific position
-    _getch();
+    readKey();
 }
 
 // ─── Display All Stocks ─────────────────────────────────────────
 void displayAllStocks() {
+    browseStocks(0);
+}
+
+// Page through the catalog one screen at a time. Only the visible page is
+// formatted, so large catalogs open instantly. Returns the start of the page
+// the user finished on.
+size_t browseStocks(size_t first) {
+    const size_t pageSize = DisplayUtil::CATALOG_PAGE_SIZE;
+
     SetColor(9);
-    DisplayUtil::displayStocks(stocks);
+    while (true) {
+        if (first >= stocks.size()) {
+            first = stocks.empty() ? 0 : ((stocks.size() - 1) / pageSize) * pageSize;
+        }
+        ScreenRenderer::clearScreen();
+        DisplayUtil::displayStocks(stocks, first, pageSize);
+        cout << "\n" << padLeft("\033[93m[N/PgDn] Next   [P/PgUp] Previous   [J] Jump to ID   [Enter/Q] Done\033[0m") << "\n";
+
+        int key = readKey();
+        if (key == 0 || key == 224) { // arrow and page keys arrive as two codes
+            key = readKey();
+            key = (key == 81) ? 'n' : (key == 73) ? 'p' : 0;
+        }
+        switch (tolower(key)) {
+            case 'n':
+                if (first + pageSize < stocks.size()) {
+                    first += pageSize;
+                }
+                break;
+            case 'p':
+                first = first >= pageSize ? first - pageSize : 0;
+                break;
+            case 'j': {
+                cout << padLeft("\033[95m\033[1m🔍 Jump to Product ID ▶ \033[0m");
+                int id;
+                if (cin >> id) {
+                    first = DisplayUtil::findStockPage(stocks, id, pageSize);
+                } else {
+                    cin.clear();
+                }
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                break;
+            }
+            case 'q':
+            case '\r':
+            case '\n':
+            case 27: // Esc
+                return first;
+            default:
+                break;
+        }
+    }
 }
 void trackInventory() {
-    system("cls");
-    
-    // Dynamic centering setup
-    const int tableWidth = 82;     // inside width of box
-    const int terminalWidth = 164; // adjust for your terminal width
-    int leftPadding = (terminalWidth - (tableWidth + 4)) / 2; // +4 for borders
-
-    auto padLeft = [&](const string& text) {
-        return string(leftPadding, ' ') + text;
-    };
+    ScreenRenderer::clearScreen();
     
-    auto centerText = [&](const string& text) {
-        int spacesLeft = (tableWidth - text.size()) / 2;
-        int spacesRight = tableWidth - text.size() - spacesLeft;
-        return string(spacesLeft, ' ') + text + string(spacesRight, ' ');
-    };
 
     cout << "\033[34m\033[1m"; // Blue and bold
     cout << padLeft("  _______             _      _____                      _                   ") << "\n";
@@ -1624,15 +1765,19 @@ void trackInventory() {
         return;
     }
 
+    checkoutEngine.expireReservations(); // drop holds of abandoned carts
+
     int totalUniqueItems = stocks.size();
     long long totalQuantity = 0; // Use long long for total quantity to prevent overflow
-    double totalPrice = 0.0; // Variable to store total price
-    vector<Stock> lowStockItems;
+    long long totalReserved = 0; // Units held by shopping carts
+    Money totalPrice; // Variable to store total price
+    vector<reference_wrapper<const Stock>> lowStockItems; // no copies of the records
 
     for (const auto& stock : stocks) {
         totalQuantity += stock.getQuantity();
-        totalPrice += (static_cast<double>(stock.getQuantity()) * stock.getPrice()); // Calculate total price
-        if (stock.getQuantity() < LOW_STOCK_THRESHOLD) {
+        totalReserved += checkoutEngine.getReserved(stock.getId());
+        totalPrice += stock.getPrice() * stock.getQuantity(); // Calculate total price
+        if (stock.getQuantity() < stock.getReorderThreshold()) {
             lowStockItems.push_back(stock);
         }
     }
@@ -1642,39 +1787,39 @@ void trackInventory() {
     cout << "\n" << padLeft("╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
     cout << padLeft("║") << "\033[93m" << centerText("📊 INVENTORY STATISTICS") << "\033[96m" << "  ║\n";
     cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
-    printf("%s║  📦 Total Unique Products: %-6d      │   📊 Total Items: %-8lld              ║%s\n", 
-           string(leftPadding, ' ').c_str(), totalUniqueItems, totalQuantity, "\033[0m");
-    printf("%s\033[96m║  💰 \033[96mTotal Inventory Value: $%-10.2f │   ⚠️  Low Stock Threshold: %-3d           \033[96m║\033[0m%s\n", 
-           string(leftPadding, ' ').c_str(), totalPrice, LOW_STOCK_THRESHOLD, "\033[0m");
+    ScreenRenderer::printf("%s║  📦 Total Unique Products: %-6d      │   📊 Total Items: %-8lld              ║%s\n", 
+           Layout::margin(), totalUniqueItems, totalQuantity, "\033[0m");
+    ScreenRenderer::printf("%s\033[96m║  💰 \033[96mTotal Inventory Value: $%-10s │   ⚠️  Default Threshold:   %-3d           \033[96m║\033[0m%s\n", 
+           Layout::margin(), totalPrice.toString().c_str(), LOW_STOCK_THRESHOLD, "\033[0m");
+    ScreenRenderer::printf("%s\033[96m║  🛒 Reserved in Carts: %-10lld  │   ✅ Available Units: %-10lld            ║%s\n", 
+           Layout::margin(), totalReserved, totalQuantity - totalReserved, "\033[0m");
     cout << "\033[96m";
     cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\n";
     cout << "\033[0m";
     // TABLE 2: Low Stock Items
     cout << "\033[96m\033[1m";
     cout << "\n" << padLeft("╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
-    printf("%s║%s                      🚨 LOW STOCK ALERTS (< %d items)                      %s      ║%s\n", 
-           string(leftPadding, ' ').c_str(), "\033[91m", LOW_STOCK_THRESHOLD, "\033[96m", "\033[0m");
+    cout << padLeft("║") << "\033[91m" << centerText("🚨 LOW STOCK ALERTS (below reorder level)") << "\033[96m" << "  ║\n";
     cout << "\033[96m";
     cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
     
     if (lowStockItems.empty()) {
         cout << padLeft("║") << "\033[92m" << centerText("✅ ALL STOCK LEVELS OK! No items running low. 🎉") << "\033[96m" << "   ║\n";
     } else {
-        cout << padLeft("║  ID  │         Product Name        │  Stock  │   Price   │   Total Value         ║\n");
+        using LowStockTable = Layout::TableLayout<
+            Layout::Column<6, Layout::Align::Center, Layout::Color::Red>,
+            Layout::Column<30, Layout::Align::Left, Layout::Color::Red>,
+            Layout::Column<9, Layout::Align::Center, Layout::Color::Red>,
+            Layout::Column<11, Layout::Align::Right, Layout::Color::Red>,
+            Layout::Column<16, Layout::Align::Right, Layout::Color::Red>>;
+        LowStockTable::header(cout, Layout::Color::Cyan, "ID", "Product Name", "Stock", "Price", "Total Value");
         cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
         cout << "\033[0m";
 
         SetColor(11); // Light red for low stock items
-        for (const auto& item : lowStockItems) {
-            double itemValue = item.getPrice() * item.getQuantity();
-            printf("%s\033[96m║ \033[91m%3d  │ %-28s│   %3d   │  $%7.2f │    $%8.2f          \033[96m║%s\n",
-                   string(leftPadding, ' ').c_str(),
-                   item.getId(),
-                   item.getName().length() > 28 ? (item.getName().substr(0, 25) + "...").c_str() : item.getName().c_str(),
-                   item.getQuantity(),
-                   item.getPrice(),
-                   itemValue,
-                   "\033[0m");
+        for (const Stock& item : lowStockItems) {
+            LowStockTable::row(cout, item.getId(), item.getName(), item.getQuantity(), item.getPrice(),
+                               item.getPrice() * item.getQuantity());
         }
         cout << "\033[96m";
     }
@@ -1690,22 +1835,8 @@ void trackInventory() {
 
 //Function Generate Low Stock Alerts
 void generateLowStockAlerts() {
-    system("cls");
+    ScreenRenderer::clearScreen();
     
-    // Dynamic centering setup
-    const int tableWidth = 82;     // inside width of box
-    const int terminalWidth = 164; // adjust for your terminal width
-    int leftPadding = (terminalWidth - (tableWidth + 4)) / 2; // +4 for borders
-
-    auto padLeft = [&](const string& text) {
-        return string(leftPadding, ' ') + text;
-    };
-    
-    auto centerText = [&](const string& text) {
-        int spacesLeft = (tableWidth - text.size()) / 2;
-        int spacesRight = tableWidth - text.size() - spacesLeft;
-        return string(spacesLeft, ' ') + text + string(spacesRight, ' ');
-    };
 
     SetColor(9);
 
@@ -1730,11 +1861,12 @@ void generateLowStockAlerts() {
     cout << "\b\b\b\b\b\b\b\b";  // Go back 8 spaces (4 symbols × 2 bytes each)
     cout << "        ";          // Print spaces to erase
     cout << "\b\b\b\b\b\b\b\b";  // Move cursor back again to the start 
-    vector<Stock> LowStockItems;
-    
-    for (const auto& stock : stocks){
-        if (stock.getQuantity() < LOW_STOCK_THRESHOLD){
-            LowStockItems.push_back(stock);
+    vector<reference_wrapper<const Stock>> LowStockItems; // no copies of the records
+
+    // The alert tracker already knows which items are below their threshold
+    for (int lowId : stockAlerts.getLowStockIds()) {
+        if (const Stock* stock = findStockById(lowId)) {
+            LowStockItems.push_back(*stock);
         }
     }
 
@@ -1743,10 +1875,10 @@ void generateLowStockAlerts() {
     cout << "\n" << padLeft("╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
     cout << padLeft("║") << "\033[93m" << centerText("📊 ALERT SUMMARY") << "\033[96m" << "  ║\n";
     cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
-    printf("%s║  📦 Total Products Scanned: %-6d  │  ⚠️  Low Stock Threshold: %-3d               ║%s\n", 
-           string(leftPadding, ' ').c_str(), static_cast<int>(stocks.size()), LOW_STOCK_THRESHOLD, "\033[0m");
-    printf("%s\033[96m║  🚨 Items Below Threshold: %-7d  │  📈 Alert Status: %-15s          ║%s\n", 
-           string(leftPadding, ' ').c_str(), static_cast<int>(LowStockItems.size()),
+    ScreenRenderer::printf("%s║  📦 Total Products Scanned: %-6d  │  ⚠️  Default Threshold:   %-3d               ║%s\n", 
+           Layout::margin(), static_cast<int>(stocks.size()), LOW_STOCK_THRESHOLD, "\033[0m");
+    ScreenRenderer::printf("%s\033[96m║  🚨 Items Below Threshold: %-7d  │  📈 Alert Status: %-15s          ║%s\n", 
+           Layout::margin(), static_cast<int>(LowStockItems.size()),
            LowStockItems.empty() ? "ALL CLEAR" : "ACTION NEEDED", "\033[0m");
     cout << "\033[96m";
     cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\n";
@@ -1755,8 +1887,8 @@ void generateLowStockAlerts() {
     // TABLE 2: Low Stock Items
     cout << "\033[96m\033[1m";
     cout << "\n" << padLeft("╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
-    printf("%s║%s                         🚨 LOW STOCK ITEMS DETAILS                         %s      ║%s\n", 
-           string(leftPadding, ' ').c_str(), "\033[91m", "\033[96m", "\033[0m");
+    ScreenRenderer::printf("%s║%s                         🚨 LOW STOCK ITEMS DETAILS                         %s      ║%s\n", 
+           Layout::margin(), "\033[91m", "\033[96m", "\033[0m");
     cout << "\033[96m";
     cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
     
@@ -1767,41 +1899,165 @@ void generateLowStockAlerts() {
         cout << padLeft("║") << "\033[95m" << centerText("Great inventory management! 🎉") << "\033[96m" << "  ║\n";
         cout << padLeft("║") << centerText("") << "║\n";
     } else {
-        cout << padLeft("║  ID  │         Product Name         │  Stock  │   Price   │   Status             ║\n");
+        using AlertTable = Layout::TableLayout<
+            Layout::Column<6, Layout::Align::Center, Layout::Color::Red>,
+            Layout::Column<30, Layout::Align::Left, Layout::Color::Red>,
+            Layout::Column<9, Layout::Align::Center, Layout::Color::Red>,
+            Layout::Column<11, Layout::Align::Right, Layout::Color::Red>,
+            Layout::Column<16, Layout::Align::Left, Layout::Color::Red>>;
+        AlertTable::header(cout, Layout::Color::Cyan, "ID", "Product Name", "Stock", "Price", "Status");
         cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
         cout << "\033[0m";
 
         SetColor(1); // Light red for low stock items
-        for (const auto& item : LowStockItems){
-            string status;
+        for (const Stock& item : LowStockItems){
+            const char* status;
             if (item.getQuantity() == 0) {
                 status = "OUT OF STOCK";
-            } else if (item.getQuantity() <= LOW_STOCK_THRESHOLD / 2) {
+            } else if (item.getQuantity() <= item.getReorderThreshold() / 2) {
                 status = "CRITICAL LOW";
             } else {
                 status = "LOW STOCK";
             }
-            
-            printf("%s\033[96m║ \033[91m%3d  │ %-28s │   %3d   │ $%7.2f  │ %-13s        \033[96m║%s\n",
-                   string(leftPadding, ' ').c_str(),
-                   item.getId(),
-                   item.getName().length() > 28 ? (item.getName().substr(0, 25) + "...").c_str() : item.getName().c_str(),
-                   item.getQuantity(),
-                   item.getPrice(),
-                   status.c_str(),
-                   "\033[0m");
+
+            AlertTable::row(cout, item.getId(), item.getName(), item.getQuantity(), item.getPrice(), status);
         }
         cout << "\033[96m";
     }
     cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\n";
     cout << "\033[0m";
+
+    // TABLE 3: Latest alert events, newest first
+    vector<string> recentAlerts = stockAlerts.getRecentAlerts(5);
+    cout << "\033[96m\033[1m";
+    cout << "\n" << padLeft("╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
+    cout << padLeft("║") << "\033[93m" << centerText("🔔 RECENT ALERT EVENTS") << "\033[96m" << "  ║\n";
+    cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
+    if (recentAlerts.empty()) {
+        cout << padLeft("║") << "\033[92m" << centerText("✅ No threshold crossings this session.") << "\033[96m" << " ║\n";
+    } else {
+        using EventTable = Layout::TableLayout<
+            Layout::Column<21, Layout::Align::Left, Layout::Color::Yellow>,
+            Layout::Column<15, Layout::Align::Left, Layout::Color::Yellow>,
+            Layout::Column<6, Layout::Align::Center, Layout::Color::Yellow>,
+            Layout::Column<36, Layout::Align::Left, Layout::Color::Yellow>>;
+        EventTable::header(cout, Layout::Color::Cyan, "Time", "Event", "ID", "Product Name");
+        cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
+        for (auto alert = recentAlerts.rbegin(); alert != recentAlerts.rend(); ++alert) {
+            // time,kind,id,quantity,threshold,name
+            vector<string> fields;
+            size_t start = 0;
+            for (int i = 0; i < 5; ++i) {
+                size_t comma = alert->find(',', start);
+                if (comma == string::npos) {
+                    break;
+                }
+                fields.push_back(alert->substr(start, comma - start));
+                start = comma + 1;
+            }
+            if (fields.size() < 5) {
+                continue;
+            }
+            EventTable::row(cout, fields[0], fields[1], fields[2], string_view(*alert).substr(start));
+        }
+    }
+    cout << "\033[96m" << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\n";
+    cout << "\033[0m";
+
+    // TABLE 4: Restock Recommendations from sales velocity
+    vector<RestockPlanner::Recommendation> restock;
+    for (const auto& rec : restockPlanner.plan(stocks, time(nullptr))) {
+        if (rec.suggestedOrder > 0) {
+            restock.push_back(rec);
+        }
+    }
+    sort(restock.begin(), restock.end(), [](const RestockPlanner::Recommendation& a, const RestockPlanner::Recommendation& b) {
+        return a.daysUntilStockout < b.daysUntilStockout;
+    });
+
+    cout << "\033[96m\033[1m";
+    cout << "\n" << padLeft("╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
+    cout << padLeft("║") << "\033[93m" << centerText("📦 RESTOCK RECOMMENDATIONS") << "\033[96m" << "  ║\n";
+    cout << padLeft("║") << "\033[95m" << centerText("Based on recent sales velocity, covering " +
+                                                  to_string(static_cast<int>(restockPlanner.getLeadTimeDays() + restockPlanner.getCoverDays())) +
+                                                  " days") << "\033[96m" << "║\n";
+    cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
+    if (restock.empty()) {
+        cout << padLeft("║") << "\033[92m" << centerText("✅ No item is projected to run out soon.") << "\033[96m" << " ║\n";
+    } else {
+        using RestockTable = Layout::TableLayout<
+            Layout::Column<6, Layout::Align::Center, Layout::Color::Yellow>,
+            Layout::Column<30, Layout::Align::Left, Layout::Color::Yellow>,
+            Layout::Column<9, Layout::Align::Right, Layout::Color::Yellow, 1>,
+            Layout::Column<11, Layout::Align::Right, Layout::Color::Yellow, 1>,
+            Layout::Column<17, Layout::Align::Center, Layout::Color::Yellow>>;
+        RestockTable::header(cout, Layout::Color::Cyan, "ID", "Product Name", "Per Day", "Days Left", "Suggested Order");
+        cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
+        const size_t maxRows = 10;
+        for (size_t i = 0; i < restock.size() && i < maxRows; ++i) {
+            const Stock* item = findStockById(restock[i].stockId);
+            if (!item) {
+                continue;
+            }
+            RestockTable::row(cout, item->getId(), item->getName(), restock[i].dailyVelocity,
+                              restock[i].daysUntilStockout, restock[i].suggestedOrder);
+        }
+    }
+    cout << "\033[96m" << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\n";
+    cout << "\033[0m";
     
     cout << padLeft("\033[93m📋 Press any key to go back to the menu...\033[0m") << "\n";
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
     cin.get();
 }
+
+// ─── Memory Usage ───────────────────────────────────────────────
+void displayMemoryUsage() {
+    ScreenRenderer::clearScreen();
+    SetColor(9);
+
+    cout << "\033[96m\033[1m";
+    cout << "\n" << padLeft("╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
+    cout << padLeft("║") << centerText("") << "║\n";
+    cout << padLeft("║") << "\033[93m" << centerText("🧠 MEMORY USAGE BY SUBSYSTEM") << "\033[96m" << "  ║\n";
+    cout << padLeft("║") << "\033[95m" << centerText("Heap bytes held by each part of the program") << "\033[96m" << "║\n";
+    cout << padLeft("║") << centerText("") << "║\n";
+    cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
+
+    using MemoryTable = Layout::TableLayout<
+        Layout::Column<18, Layout::Align::Left, Layout::Color::White>,
+        Layout::Column<14, Layout::Align::Right, Layout::Color::Green, 1>,
+        Layout::Column<14, Layout::Align::Right, Layout::Color::Yellow, 1>,
+        Layout::Column<16, Layout::Align::Right, Layout::Color::White>,
+        Layout::Column<16, Layout::Align::Right, Layout::Color::White>>;
+    MemoryTable::header(cout, Layout::Color::Cyan, "Subsystem", "Live KiB", "Peak KiB", "Allocations", "Live Blocks");
+    cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
+    for (int i = 0; i < MemoryTracker::SUBSYSTEM_COUNT; ++i) {
+        auto subsystem = static_cast<MemoryTracker::Subsystem>(i);
+        MemoryTracker::Usage usage = MemoryTracker::getUsage(subsystem);
+        MemoryTable::row(cout, MemoryTracker::getName(subsystem), usage.liveBytes / 1024.0, usage.peakBytes / 1024.0,
+                         usage.allocations, usage.allocations - usage.frees);
+    }
+    cout << "\033[96m" << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
+    MemoryTracker::Usage total = MemoryTracker::getTotal();
+    MemoryTable::row(cout, "total", total.liveBytes / 1024.0, total.peakBytes / 1024.0,
+                     total.allocations, total.allocations - total.frees);
+    cout << "\033[96m" << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\n";
+    cout << "\033[0m";
+
+    // Same numbers as the periodic export, written now
+    if (Metrics::writePrometheus("data/metrics.prom")) {
+        cout << "\n" << padLeft("\033[92m✅ Snapshot written to data/metrics.prom\033[0m") << "\n";
+    } else {
+        cout << "\n" << padLeft("\033[91m❌ Could not write data/metrics.prom\033[0m") << "\n";
+    }
+
+    cout << padLeft("\033[93m📋 Press any key to go back to the menu...\033[0m") << "\n";
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    cin.get();
+}
 void userRegister() {
-    system("cls");
+    ScreenRenderer::clearScreen();
     string username, password;
 
     // Draw registration table
@@ -1830,40 +2086,32 @@ void userRegister() {
     getline(cin, password);
 
     // Check if username already exists
-    bool userExists = false;
-    for (const auto& user : users) {
-        if (user.getUsername() == username) {
-            userExists = true;
-            break;
-        }
-    }
+    bool userExists = userIndex.contains(username);
 
     if (userExists) {
         gotoxy(5, 13);
         cout << "\033[31m                                  ❌ Username already exists. Please choose a different one.\033[0m" << endl;
     } else {
         users.emplace_back(username, password, false);
-        ExcelUtil::writeUsersToFile("data/users.xlsx", users);
+        userIndex.insert(username, users.size() - 1);
+        try {
+            ExcelUtil::writeUsersToFile("data/users.xlsx", users);
+        } catch (const exception& e) {
+            // Not saved, so not registered
+            users.pop_back();
+            userIndex.erase(username, users.size(), users);
+            gotoxy(5, 13);
+            cout << "\033[31m                                  ❌ Registration failed: " << e.what() << "\033[0m" << endl;
+            return;
+        }
         gotoxy(5, 13);
         cout << "\033[32m                                  ✅User registered successfully!\033[0m" << endl;
     }
 }
 // Function for user login and registration menu
 void userLogin() { // just add add to enable user to login or register
-    system("cls");
-        const int tableWidth = 82;     // inside width of box
-    const int terminalWidth = 164; // adjust for your terminal width
-    int leftPadding = (terminalWidth - (tableWidth + 4)) / 2; // +4 for borders
+    ScreenRenderer::clearScreen();
 
-    auto padLeft = [&](const string& text) {
-        return string(leftPadding, ' ') + text;
-    };
-    
-    auto centerText = [&](const string& text) {
-        int spacesLeft = (tableWidth - text.size()) / 2;
-        int spacesRight = tableWidth - text.size() - spacesLeft;
-        return string(spacesLeft, ' ') + text + string(spacesRight, ' ');
-    };
     int choice;
     
     // Enhanced user menu design with consistent styling
@@ -1912,7 +2160,7 @@ void userLogin() { // just add add to enable user to login or register
                 Sleep(200);
             }
             
-            system("cls");
+            ScreenRenderer::clearScreen();
             userRegister();
             break;
         }
@@ -1925,7 +2173,7 @@ void userLogin() { // just add add to enable user to login or register
                 Sleep(250);
             }
             
-            system("cls");
+            ScreenRenderer::clearScreen();
             string username, password;
             
             cout << "\033[96m\033[1m";
@@ -1951,13 +2199,13 @@ void userLogin() { // just add add to enable user to login or register
             password = getPasswordInput("");
 
             bool loginSuccess = false;
-            for (auto& user : users) {
-                if (user.getUsername() == username && user.getPassword() == password && !user.isAdmin()) {
-                    currentUser = &user;
-                    loginSuccess = true;
-                    break;
-                }
+            Metrics::ScopedTimer loginTimer("login");
+            int userPos = userIndex.find(username);
+            if (userPos != UserIndex::NOT_FOUND && users[userPos].getPassword() == password && !users[userPos].isAdmin()) {
+                currentUser = &users[userPos];
+                loginSuccess = true;
             }
+            loginTimer.stop();
             
             if (loginSuccess) {
                 // Enhanced success message
@@ -1979,7 +2227,7 @@ void userLogin() { // just add add to enable user to login or register
                 cout << padLeft("║") << "\033[94m" << centerText("Please check credentials or use admin login.") << "\033[91m" << "║\n";
                 cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
                 cout << padLeft("\033[93m⚠️  Press any key to go back to the menu...\033[0m") << "\n";
-                _getch();
+                readKey();
             }
             break;
         }
@@ -1998,7 +2246,7 @@ void userLogin() { // just add add to enable user to login or register
                 Sleep(250);
             }
             
-            system("cls");
+            ScreenRenderer::clearScreen();
             break;
         }
         default:
@@ -2011,25 +2259,12 @@ void userLogin() { // just add add to enable user to login or register
     }
 }
 void staffDashboard() { // just add add for allowing staff actions
-    system("cls");
+    ScreenRenderer::clearScreen();
     int choice;    
-    // Dynamic centering setup
-    const int tableWidth = 82;     // inside width of box
-    const int terminalWidth = 164; // adjust for your terminal width
-    int leftPadding = (terminalWidth - (tableWidth + 4)) / 2; // +4 for borders
-
-    auto padLeft = [&](const string& text) {
-        return string(leftPadding, ' ') + text;
-    };
-    
-    auto centerText = [&](const string& text) {
-        int spacesLeft = (tableWidth - text.size()) / 2;
-        int spacesRight = tableWidth - text.size() - spacesLeft;
-        return string(spacesLeft, ' ') + text + string(spacesRight, ' ');
-    };
 
     do {
-        system("cls");
+        displaySaveErrors();
+        ScreenRenderer::clearScreen();
         
         // Enhanced staff dashboard design with dynamic centering
         cout << "\033[96m\033[1m";
@@ -2056,7 +2291,10 @@ void staffDashboard() { // just add add for allowing staff actions
         cout << padLeft("║         ") << "\033[94m" << "[5] 💳 Checkout Cart" << "\033[96m" << string(53, ' ') << "║\n";
         cout << padLeft("║             ") << "\033[92m" << "└─ Complete your purchase" << "\033[96m" << string(44, ' ') << "║\n";
         cout << padLeft("║") << centerText("") << "║\n";
-        cout << padLeft("║         ") << "\033[94m" << "[6] 🚪 Logout" << "\033[96m" << string(60, ' ') << "║\n";
+        cout << padLeft("║         ") << "\033[94m" << "[6] 🧾 My Purchases" << "\033[96m" << string(54, ' ') << "║\n";
+        cout << padLeft("║             ") << "\033[92m" << "└─ Browse your past purchases" << "\033[96m" << string(40, ' ') << "║\n";
+        cout << padLeft("║") << centerText("") << "║\n";
+        cout << padLeft("║         ") << "\033[94m" << "[7] 🚪 Logout" << "\033[96m" << string(60, ' ') << "║\n";
         cout << padLeft("║             ") << "\033[92m" << "└─ Exit shopping session safely" << "\033[96m" << string(38, ' ') << "║\n";
         cout << padLeft("║") << centerText("") << "║\n";
         cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\n";
@@ -2071,7 +2309,7 @@ void staffDashboard() { // just add add for allowing staff actions
             
             // Enhanced error message
             cout << "\n" << padLeft("\033[91m\033[1m⚠️  INVALID CHOICE!\033[0m") << "\n";
-            cout << padLeft("\033[93mPlease select a number between 1 and 6 only.\033[0m") << "\n";
+            cout << padLeft("\033[93mPlease select a number between 1 and 7 only.\033[0m") << "\n";
             return staffDashboard(); // Skip to next iteration for valid input 
         }
         cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Clear the input buffer
@@ -2087,11 +2325,7 @@ void staffDashboard() { // just add add for allowing staff actions
                 cout << "\b\b\b\b\b\b\b\b";  // Go back 8 spaces (4 symbols × 2 bytes each)
                 cout << "        ";          // Print spaces to erase
                 cout << "\b\b\b\b\b\b\b\b";  // Move cursor back again to the start       
-                system("cls");              
                 displayAllStocks();
-                // Interactive prompt
-                cout << "    " << "\033[93m" << padLeft("⚠️  Press any key to go back to the menu...") << "\033[0m" << "\n";
-                _getch(); // Wait for any key press
                 break;
             }
             case 2:{
@@ -2105,7 +2339,7 @@ void staffDashboard() { // just add add for allowing staff actions
                 cout << "\b\b\b\b\b\b\b\b";  // Go back 8 spaces (4 symbols × 2 bytes each)
                 cout << "        ";          // Print spaces to erase
                 cout << "\b\b\b\b\b\b\b\b";  // Move cursor back again to the start           
-                system("cls");
+                ScreenRenderer::clearScreen();
                 searchStock();
                 break;
             }
@@ -2120,7 +2354,7 @@ void staffDashboard() { // just add add for allowing staff actions
                 cout << "\b\b\b\b\b\b\b\b";  // Go back 8 spaces (4 symbols × 2 bytes each)
                 cout << "        ";          // Print spaces to erase
                 cout << "\b\b\b\b\b\b\b\b";  // Move cursor back again to the start               
-                system("cls");
+                ScreenRenderer::clearScreen();
                 addItemToCart(); // Call the new function
                 break;
             }
@@ -2135,7 +2369,7 @@ void staffDashboard() { // just add add for allowing staff actions
                 cout << "\b\b\b\b\b\b\b\b";  // Go back 8 spaces (4 symbols × 2 bytes each)
                 cout << "        ";          // Print spaces to erase
                 cout << "\b\b\b\b\b\b\b\b";  // Move cursor back again to the start       
-                system("cls");
+                ScreenRenderer::clearScreen();
                 viewCart(); // Call the new function
                 break;
             }
@@ -2151,7 +2385,7 @@ void staffDashboard() { // just add add for allowing staff actions
                 cout << "        ";          // Print spaces to erase
                 cout << "\b\b\b\b\b\b\b\b";  // Move cursor back again to the start       
                 if (currentUser) {
-                    checkoutCart(currentUser->getUsername()); // Pass current user's username
+                    checkoutCart(string(currentUser->getUsername())); // Pass current user's username
                 } else {
                     // Enhanced error message for no user
                     cout << "\n" << padLeft("\033[91m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
@@ -2163,6 +2397,11 @@ void staffDashboard() { // just add add for allowing staff actions
                 break;
             }
             case 6:{
+                ScreenRenderer::clearScreen();
+                viewMyPurchases();
+                break;
+            }
+            case 7:{
                 // Enhanced logout message
                 cout << "\n" << padLeft("\033[93m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
                 cout << padLeft("║") << "\033[91m" << centerText("👋 LOGGING OUT...") << "\033[93m" << "║" << "\n";
@@ -2170,18 +2409,18 @@ void staffDashboard() { // just add add for allowing staff actions
                 cout << padLeft("║") << "\033[96m" << centerText("Session ended successfully...") << "\033[93m" << "║" << "\n";
                 cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n\n";
                 
-                system("cls");
+                ScreenRenderer::clearScreen();
                 currentUser = nullptr; // Clear current user on logout
                 break;
             }
             default:{
                 // Enhanced error for invalid choice
                 cout << "\n" << padLeft("\033[91m\033[1m⚠️  INVALID CHOICE!\033[0m") << "\n";
-                cout << padLeft("\033[93mPlease select a number between 1 and 6 only.\033[0m") << "\n";
+                cout << padLeft("\033[93mPlease select a number between 1 and 7 only.\033[0m") << "\n";
                 break;
             }
         }
-    } while (choice != 6);
+    } while (choice != 7);
 }          
 // Buy Stock Function (for staff)
 void buyStock() {
@@ -2200,29 +2439,48 @@ void buyStock() {
     });
 
     if (it != stocks.end()) {
-        if (it->getQuantity() >= quantity) {
+        static LatencyHistogram& checkoutLatency = Metrics::histogram("checkout");
+        Metrics::ScopedTimer checkoutTimer(checkoutLatency);
+        vector<int> failedIds;
+        if (checkoutEngine.checkout({{id, quantity}}, failedIds)) {
             // Create a temporary vector to hold the single item for the receipt
-            vector<pair<Stock, int>> items;
-            items.push_back({*it, quantity});
+            vector<Receipt::Item> items;
+            items.push_back(Receipt::makeItem(*it, quantity));
             
             // Create a receipt
             // Note: In a real-world app, receipt IDs would be persisted and tracked.
             // For now, we'll use a simple counter based on the global receipts vector size.
             //int receiptId = receipts.size() + 1;
             int receiptId = ExcelUtil::getNextReceiptId(receipts);  
-            string username = (currentUser != nullptr) ? currentUser->getUsername() : "Guest";
-            Receipt newReceipt(receiptId, items, username); // Pass username to Receipt constructor
-            receipts.push_back(newReceipt);
+            string username = (currentUser != nullptr) ? string(currentUser->getUsername()) : "Guest";
+            receipts.emplace_back(receiptId, items, username); // Pass username to Receipt constructor
+            const Receipt& newReceipt = receipts.back();
+            salesAnalytics.addReceipt(newReceipt);
+            topSellers.addReceipt(newReceipt);
+            receiptTimeIndex.add(newReceipt, receipts.size() - 1);
+            userReceiptIndex.add(username, receipts.size() - 1);
+            restockPlanner.addReceipt(newReceipt);
 
             // Update the stock quantity
-            it->setQuantity(it->getQuantity() - quantity);
-            ExcelUtil::writeStockToFile("data/stock.xlsx", stocks);
+            int oldQuantity = it->getQuantity();
+            it->setQuantity(checkoutEngine.getQuantity(id));
+            stockAlerts.onQuantityChange(*it, oldQuantity);
+            bool catalogSaved = stockDb.put(*it);
+            bool receiptSaved = ReceiptStore::append(RECEIPT_STORE_FILE, receipts);
+            checkoutTimer.stop();
 
             cout << "\nPurchase successful!" << endl;
+            if (!catalogSaved) {
+                cout << "Warning: the new stock level could not be saved to the catalog file." << endl;
+            }
+            if (!receiptSaved) {
+                cout << "Warning: the receipt could not be saved to the receipt store." << endl;
+            }
             cout << "Receipt ID: " << newReceipt.getReceiptId() << endl;
             cout << "Items purchased: " << it->getName() << " x " << quantity << endl;
-            cout << "Total Price: $" << fixed << setprecision(2) << newReceipt.getTotalPrice() << endl;
+            cout << "Total Price: $" << newReceipt.getTotalPrice().toString() << endl;
         } else {
+            checkoutTimer.stop();
             cout << "Insufficient stock. Available quantity: " << it->getQuantity() << endl;
         }
     } else {
@@ -2231,25 +2489,13 @@ void buyStock() {
 }
 // Function to add an item to the global cart
 void addItemToCart() {
-    system("cls");
-    
-    // Dynamic centering setup
-    const int tableWidth = 82;     // inside width of box
-    const int terminalWidth = 164; // adjust for your terminal width
-    int leftPadding = (terminalWidth - (tableWidth + 4)) / 2; // +4 for borders
-
-    auto padLeft = [&](const string& text) {
-        return string(leftPadding, ' ') + text;
-    };
+    size_t catalogPage = browseStocks(0); // let the cashier find the ID first
+    ScreenRenderer::clearScreen();
     
-    auto centerText = [&](const string& text) {
-        int spacesLeft = (tableWidth - text.size()) / 2;
-        int spacesRight = tableWidth - text.size() - spacesLeft;
-        return string(spacesLeft, ' ') + text + string(spacesRight, ' ');
-    };
-
 
     SetColor(9);
+    checkoutEngine.expireReservations(); // drop holds of abandoned carts
+    string owner = (currentUser != nullptr) ? string(currentUser->getUsername()) : "Guest";
 
     // Enhanced add to cart design with dynamic centering
     // cout << "\033[96m\033[1m";
@@ -2266,8 +2512,9 @@ void addItemToCart() {
 
     // Display available stocks with enhanced styling
     cout << "\n";
-    displayAllStocks(); // Show available stocks
+    int catalogLines = DisplayUtil::displayStocks(stocks, catalogPage); // Show the page the cashier stopped on
     cout << "\n";
+    const int formTop = 2 + catalogLines; // screen row of the form's top border
 
     // Input section with enhanced styling
     cout << "\033[96m\033[1m";
@@ -2287,11 +2534,11 @@ void addItemToCart() {
     int id, qty;
 
     // Get Product ID with input validation and positioning
-    gotoxy(64, 19); // Adjust Y coordinate based on your display
+    gotoxy(64, formTop + 4); // Adjust Y coordinate based on your display
     while (!(cin >> id) || id <= 0) {
         cin.clear();
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
-        gotoxy(39, 27);
+        gotoxy(39, formTop + 12);
         cout << "\033[91m❌ Invalid input! Please enter a valid Product ID ▶ \033[0m";
     }
     // cin.ignore(numeric_limits<streamsize>::max(), '\n');
@@ -2299,7 +2546,7 @@ void addItemToCart() {
     // Find the stock item
     auto it = find_if(stocks.begin(), stocks.end(), [id](const Stock& s){return s.getId()==id;});
     if (it == stocks.end()) {
-        gotoxy(20, 27);
+        gotoxy(20, formTop + 12);
         cout << "\n" << padLeft("\033[91m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
         cout << padLeft("║") << "\033[93m" << "                             ❌ PRODUCT NOT FOUND!                           " << "\033[91m" << "     ║" << "\n";
         cout << padLeft("║") << "\033[96m" <<  centerText("The specified Product ID does not exist") << "\033[91m" << "║" << "\n";
@@ -2311,62 +2558,58 @@ void addItemToCart() {
     }
 
     // Display selected product info
-        gotoxy(20,27);
+        gotoxy(20, formTop + 12);
     cout << "\n" << padLeft("\033[93m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
     cout << padLeft("║") << "\033[96m" << "                             📦 PRODUCT SELECTED                   " << "\033[93m" << "               ║" << "\n";
-    string productInfo = "Product: " + it->getName() + " | Price: $" + to_string((int)(it->getPrice() * 100) / 100.0);
-    string stockInfo = "Available Stock: " + to_string(it->getQuantity()) + " items";
+    string productInfo = "Product: " + it->getName() + " | Price: $" + it->getPrice().toString();
+    string stockInfo = "Available Stock: " + to_string(checkoutEngine.getAvailable(id)) + " items";
     cout << padLeft("║") << "\033[97m" << centerText(productInfo) << "\033[93m" << "║" << "\n";
     cout << padLeft("║") << "\033[97m" << centerText(stockInfo) << "\033[93m" << "║" << "\n";
     cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
 
     // Get quantity with positioning
-    gotoxy(62, 22); // Adjust Y coordinate based on your display
+    gotoxy(62, formTop + 7); // Adjust Y coordinate based on your display
     while (!(cin >> qty) || qty <= 0) {
         cin.clear();
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
-        gotoxy(39, 32);
+        gotoxy(39, formTop + 17);
         cout << "\033[91m❌ Invalid input! Quantity must be a positive number ▶ \033[0m";
     }
     
-    // Validate quantity and process
-    if (qty > 0 && qty <= it->getQuantity()) {
-        // Check if item already in cart, if so, update quantity
-        auto cart_it = find_if(cart.begin(), cart.end(), [id](const pair<Stock, int>& p){
-            return p.first.getId() == id;
-        });
-
-        if (cart_it != cart.end()) {
-            // Item already in cart, update its quantity
-            int oldQty = cart_it->second;
-            cart_it->second += qty;
+    // Validate quantity and hold it for this cart until the reservation expires
+    static LatencyHistogram& cartLatency = Metrics::histogram("add_to_cart");
+    Metrics::ScopedTimer cartTimer(cartLatency);
+    bool reserved = qty > 0 && checkoutEngine.reserve(owner, id, qty, CART_RESERVATION_TTL);
+    // Add to this user's cart; if the item was already there its quantity grows
+    int totalInCart = reserved ? carts.addItem(owner, id, qty) : 0;
+    cartTimer.stop();
+    if (reserved) {
+
+        if (totalInCart > qty) {
             
             // Success message for updated quantity
-                gotoxy(20, 32);
+                gotoxy(20, formTop + 17);
             cout << "\n" << padLeft("\033[92m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
             cout << padLeft("║") << "\033[93m" << centerText("✅ CART UPDATED SUCCESSFULLY!") << "\033[92m" << "║" << "\n";
             cout << padLeft("║") << "\033[96m" << centerText("+ " + to_string(qty) + " more " + it->getName() + " added") << "\033[92m" << "║" << "\n";
-            cout << padLeft("║") << "\033[97m" << centerText("Total in cart: " + to_string(cart_it->second) + " items") << "\033[92m" << "║" << "\n";
+            cout << padLeft("║") << "\033[97m" << centerText("Total in cart: " + to_string(totalInCart) + " items") << "\033[92m" << "║" << "\n";
             cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
         } else {
-            // Item not in cart, add new entry
-            cart.push_back({*it, qty});
-            
             // Success message for new item
-            gotoxy(20, 32);
+            gotoxy(20, formTop + 17);
             cout << "\n" << padLeft("\033[92m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
             cout << padLeft("║") << "\033[93m" << "                               ✅ ITEM ADDED TO CART!                             " << "\033[92m" << "║" << "\n";
             cout << padLeft("║") << "\033[96m" << centerText(to_string(qty) + " x " + it->getName() + " added successfully") << "\033[92m" << "║" << "\n";
-            double itemTotal = qty * it->getPrice();
-            cout << padLeft("║") << "\033[97m" << centerText("Item Total: $" + to_string((int)(itemTotal * 100) / 100.0)) << "\033[92m" << "║" << "\n";
+            Money itemTotal = it->getPrice() * qty;
+            cout << padLeft("║") << "\033[97m" << centerText("Item Total: $" + itemTotal.toString()) << "\033[92m" << "║" << "\n";
             cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
         }
     } else {
         // Error message for invalid quantity
-        gotoxy(20, 32);
+        gotoxy(20, formTop + 17);
         cout << "\n" << padLeft("\033[91m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
         cout << padLeft("║") << "\033[93m" << "                               ❌ INVALID QUANTITY!                     " << "\033[91m" << "          ║" << "\n";
-        cout << padLeft("║") << "\033[96m" << centerText("Requested: " + to_string(qty) + " | Available: " + to_string(it->getQuantity())) << "\033[91m" << "║" << "\n";
+        cout << padLeft("║") << "\033[96m" << centerText("Requested: " + to_string(qty) + " | Available: " + to_string(checkoutEngine.getAvailable(id))) << "\033[91m" << "║" << "\n";
         cout << padLeft("║") << "\033[97m" << centerText("Please enter a valid quantity") << "\033[91m" << "║" << "\n";
         cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
     }
@@ -2375,27 +2618,14 @@ void addItemToCart() {
     cout << "\n" << padLeft("\033[94m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
     cout << padLeft("║") << "\033[96m" << centerText("Press any key to go back to the menu...") << "\033[94m" << "║" << "\n";
     cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
-    _getch(); // Wait for any key press
+    readKey(); // Wait for any key press
 }
 // Function to view the contents of the global cart
 
 void printStockReport() {
-    system("cls");
-    
-    // Dynamic centering setup
-    const int tableWidth = 82;     // inside width of box
-    const int terminalWidth = 164; // adjust for your terminal width
-    int leftPadding = (terminalWidth - (tableWidth + 4)) / 2; // +4 for borders
-
-    auto padLeft = [&](const string& text) {
-        return string(leftPadding, ' ') + text;
-    };
+    ScreenRenderer::clearScreen();
+    Metrics::ScopedTimer reportTimer("report"); // building the frame; it is shown by readKey()
     
-    auto centerText = [&](const string& text) {
-        int spacesLeft = (tableWidth - text.size()) / 2;
-        int spacesRight = tableWidth - text.size() - spacesLeft;
-        return string(spacesLeft, ' ') + text + string(spacesRight, ' ');
-    };
 
     // ASCII Art Header
     cout << "\033[35m"; // Magenta
@@ -2425,7 +2655,7 @@ void printStockReport() {
     // Stats Setup
     int totalItems = 0;
     int totalQuantity = 0;
-    double totalValue = 0;
+    Money totalValue;
 
     const Stock* mostExpensive = nullptr;
     const Stock* leastExpensive = nullptr;
@@ -2433,7 +2663,7 @@ void printStockReport() {
     const Stock* leastStocked = nullptr;
 
     for (const auto& s : stocks) {
-        double itemValue = s.getQuantity() * s.getPrice();
+        Money itemValue = s.getPrice() * s.getQuantity();
         totalItems++;
         totalQuantity += s.getQuantity();
         totalValue += itemValue;
@@ -2460,11 +2690,11 @@ void printStockReport() {
     // Format summary data with proper spacing
     string totalItemsStr = "📦 Total Items: " + to_string(totalItems);
     string totalQuantityStr = "📊 Total Quantity: " + to_string(totalQuantity);
-    string totalValueStr = "💰 Inventory Value: $" + to_string((int)(totalValue * 100) / 100.0);
+    string totalValueStr = "💰 Inventory Value: $" + totalValue.toString();
     
-    cout << padLeft("║         ") << "\033[92m" << totalItemsStr << "\033[96m" << string(tableWidth - 9 - totalItemsStr.length(), ' ') << "  ║\n";
-    cout << padLeft("║         ") << "\033[92m" << totalQuantityStr << "\033[96m" << string(tableWidth - 9 - totalQuantityStr.length(), ' ') << "  ║\n";
-    cout << padLeft("║         ") << "\033[92m" << totalValueStr << "\033[96m" << string(tableWidth - 9 - totalValueStr.length(), ' ') << "  ║\n";
+    cout << padLeft("║         ") << "\033[92m" << totalItemsStr << "\033[96m" << string(Layout::TABLE_WIDTH - 9 - totalItemsStr.length(), ' ') << "  ║\n";
+    cout << padLeft("║         ") << "\033[92m" << totalQuantityStr << "\033[96m" << string(Layout::TABLE_WIDTH - 9 - totalQuantityStr.length(), ' ') << "  ║\n";
+    cout << padLeft("║         ") << "\033[92m" << totalValueStr << "\033[96m" << string(Layout::TABLE_WIDTH - 9 - totalValueStr.length(), ' ') << "  ║\n";
     cout << padLeft("║") << centerText("") << "║\n";
     
     // Product Statistics Section
@@ -2474,28 +2704,98 @@ void printStockReport() {
     cout << padLeft("║") << centerText("") << "║\n";
 
     if (mostExpensive) {
-        string expensiveStr = "💎 Most Expensive: " + mostExpensive->getName() + " ($" + to_string((int)(mostExpensive->getPrice() * 100) / 100.0) + ")";
-        cout << padLeft("║         ") << "\033[93m" << expensiveStr << "\033[96m" << string(tableWidth - 9 - expensiveStr.length(), ' ') << "  ║\n";
+        string expensiveStr = "💎 Most Expensive: " + mostExpensive->getName() + " ($" + mostExpensive->getPrice().toString() + ")";
+        cout << padLeft("║         ") << "\033[93m" << expensiveStr << "\033[96m" << string(Layout::TABLE_WIDTH - 9 - expensiveStr.length(), ' ') << "  ║\n";
     }
 
     if (leastExpensive) {
-        string cheapStr = "💵 Least Expensive: " + leastExpensive->getName() + " ($" + to_string((int)(leastExpensive->getPrice() * 100) / 100.0) + ")";
-        cout << padLeft("║         ") << "\033[93m" << cheapStr << "\033[96m" << string(tableWidth - 9 - cheapStr.length(), ' ') << "  ║\n";
+        string cheapStr = "💵 Least Expensive: " + leastExpensive->getName() + " ($" + leastExpensive->getPrice().toString() + ")";
+        cout << padLeft("║         ") << "\033[93m" << cheapStr << "\033[96m" << string(Layout::TABLE_WIDTH - 9 - cheapStr.length(), ' ') << "  ║\n";
     }
 
     if (mostStocked) {
         string stockedStr = "📈 Most Stocked: " + mostStocked->getName() + " (" + to_string(mostStocked->getQuantity()) + " items)";
-        cout << padLeft("║         ") << "\033[93m" << stockedStr << "\033[96m" << string(tableWidth - 9 - stockedStr.length(), ' ') << "  ║\n";
+        cout << padLeft("║         ") << "\033[93m" << stockedStr << "\033[96m" << string(Layout::TABLE_WIDTH - 9 - stockedStr.length(), ' ') << "  ║\n";
     }
 
     if (leastStocked) {
         string lowStockStr = "📉 Least Stocked: " + leastStocked->getName() + " (" + to_string(leastStocked->getQuantity()) + " items)";
-        cout << padLeft("║         ") << "\033[93m" << lowStockStr << "\033[96m" << string(tableWidth - 9 - lowStockStr.length(), ' ') << "  ║\n";
+        cout << padLeft("║         ") << "\033[93m" << lowStockStr << "\033[96m" << string(Layout::TABLE_WIDTH - 9 - lowStockStr.length(), ' ') << "  ║\n";
+    }
+
+    cout << padLeft("║") << centerText("") << "║\n";
+    cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
+
+    // Sales Analytics Section (served from the rollups, no scan of the history)
+    cout << padLeft("║") << centerText("") << "║\n";
+    cout << padLeft("║") << "\033[95m" << centerText("💹 SALES ANALYTICS") << "\033[96m" << "  ║\n";
+    cout << padLeft("║") << centerText("") << "║\n";
+
+    if (salesAnalytics.getReceiptCount() == 0) {
+        cout << padLeft("║") << "\033[91m" << centerText("No sales recorded yet.") << "\033[96m" << "║\n";
+    } else {
+        time_t now = time(nullptr);
+        vector<string> salesLines;
+        salesLines.push_back("💰 Total Revenue: $" + salesAnalytics.getTotalRevenue().toString() +
+                             " from " + to_string(salesAnalytics.getReceiptCount()) + " receipts");
+        salesLines.push_back("📅 Today: $" + salesAnalytics.getDayOf(now).revenue.toString() +
+                             " | This Week: $" + salesAnalytics.getWeekOf(now).revenue.toString() +
+                             " | This Month: $" + salesAnalytics.getMonthOf(now).revenue.toString());
+        char basketBuf[32];
+        snprintf(basketBuf, sizeof(basketBuf), "%.1f", salesAnalytics.getAverageBasketUnits());
+        salesLines.push_back("🛒 Average Basket: " + string(basketBuf) + " items, $" +
+                             salesAnalytics.getAverageBasketValue().toString());
+        for (const auto& period : salesAnalytics.getMonthly(3)) {
+            salesLines.push_back("📆 " + period.label + ": $" + period.revenue.toString() + " (" +
+                                 to_string(period.units) + " units, " + to_string(period.receipts) + " receipts)");
+        }
+        for (const auto& top : salesAnalytics.getTopItemsByUnits(3)) {
+            salesLines.push_back("🏅 " + Receipt::getLatestItemName(top.first) + ": " + to_string(top.second) + " units sold");
+        }
+        for (const auto& top : salesAnalytics.getTopUsersByRevenue(3)) {
+            salesLines.push_back("👤 " + top.first + ": $" + top.second.toString() + " spent");
+        }
+
+        for (auto& line : salesLines) {
+            if (line.length() > 72) {
+                line = line.substr(0, 69) + "...";
+            }
+            cout << padLeft("║         ") << "\033[94m" << line << "\033[96m" << string(Layout::TABLE_WIDTH - 9 - line.length(), ' ') << "  ║\n";
+        }
     }
 
     cout << padLeft("║") << centerText("") << "║\n";
     cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
 
+    // Best Sellers Section (approximate, from the streaming top-K summaries)
+    cout << padLeft("║") << centerText("") << "║\n";
+    cout << padLeft("║") << "\033[95m" << centerText("🔥 BEST SELLERS & TRENDING") << "\033[96m" << "  ║\n";
+    cout << padLeft("║") << centerText("") << "║\n";
+    {
+        time_t now = time(nullptr);
+        vector<string> trendLines;
+        for (const auto& top : topSellers.getTopByUnits(3, 24 * 60 * 60, now)) {
+            trendLines.push_back("🔥 Last 24h: " + Receipt::getLatestItemName(top.first) + " - " + to_string(top.second) + " units");
+        }
+        for (const auto& top : topSellers.getTopByUnits(3, 7 * 24 * 60 * 60, now)) {
+            trendLines.push_back("📈 Last 7 days: " + Receipt::getLatestItemName(top.first) + " - " + to_string(top.second) + " units");
+        }
+        for (const auto& top : topSellers.getTopByRevenue(3, 0, now)) {
+            trendLines.push_back("💎 All time: " + Receipt::getLatestItemName(top.first) + " - $" + top.second.toString() + " revenue");
+        }
+        if (trendLines.empty()) {
+            cout << padLeft("║") << "\033[91m" << centerText("No sales recorded yet.") << "\033[96m" << "║\n";
+        }
+        for (auto& line : trendLines) {
+            if (line.length() > 72) {
+                line = line.substr(0, 69) + "...";
+            }
+            cout << padLeft("║         ") << "\033[93m" << line << "\033[96m" << string(Layout::TABLE_WIDTH - 9 - line.length(), ' ') << "  ║\n";
+        }
+    }
+    cout << padLeft("║") << centerText("") << "║\n";
+    cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
+
     // Recent Transactions Section
     cout << padLeft("║") << centerText("") << "║\n";
     cout << padLeft("║") << "\033[95m" << centerText("🧾 RECENT TRANSACTIONS (Last 5)") << "\033[96m" << "  ║\n";
@@ -2504,8 +2804,11 @@ void printStockReport() {
     if (receipts.empty()) {
         cout << padLeft("║") << "\033[91m" << centerText("No transactions recorded yet.") << "\033[96m" << "║\n";
     } else {
+        // Newest first by transaction time, read from the end of the time index
+        const auto& timeline = receiptTimeIndex.getEntries();
         int count = 0;
-        for (auto it = receipts.rbegin(); it != receipts.rend() && count < 5; ++it, ++count) {
+        for (auto entry = timeline.rbegin(); entry != timeline.rend() && count < 5; ++entry, ++count) {
+            const Receipt* it = &receipts[entry->position];
             time_t transactionTime = it->getTransactionTime();
             tm ptm{};
             
@@ -2514,10 +2817,10 @@ void printStockReport() {
                 char timeBuf[50];
                 strftime(timeBuf, sizeof(timeBuf), "%m/%d %H:%M", &ptm);
                 receiptInfo = "🧾 ID:" + to_string(it->getReceiptId()) + " | " + it->getUsername() + " | $" + 
-                             to_string((int)(it->getTotalPrice() * 100) / 100.0) + " | " + string(timeBuf);
+                             it->getTotalPrice().toString() + " | " + string(timeBuf);
             } else {
                 receiptInfo = "🧾 ID:" + to_string(it->getReceiptId()) + " | " + it->getUsername() + " | $" + 
-                             to_string((int)(it->getTotalPrice() * 100) / 100.0) + " | [Invalid Time]";
+                             it->getTotalPrice().toString() + " | [Invalid Time]";
             }
 
             // Truncate if too long
@@ -2525,22 +2828,24 @@ void printStockReport() {
                 receiptInfo = receiptInfo.substr(0, 69) + "...";
             }
             
-            cout << padLeft("║         ") << "\033[94m" << receiptInfo << "\033[96m" << string(tableWidth - 9 - receiptInfo.length(), ' ') << "  ║\n";
+            cout << padLeft("║         ") << "\033[94m" << receiptInfo << "\033[96m" << string(Layout::TABLE_WIDTH - 9 - receiptInfo.length(), ' ') << "  ║\n";
 
             // Show item details (limited to fit in box)
             for (const auto& item : it->getItems()) {
-                string itemInfo = "    • " + item.first.getName() + " x" + to_string(item.second) + 
-                                 " @ $" + to_string((int)(item.first.getPrice() * 100) / 100.0);
+                string itemInfo = "    • " + item.getName() + " x" + to_string(item.quantity) + 
+                                 " @ $" + item.unitPrice.toString();
                 if (itemInfo.length() > 72) {
                     itemInfo = itemInfo.substr(0, 69) + "...";
                 }
-                cout << padLeft("║         ") << "\033[97m" << itemInfo << "\033[96m" << string(tableWidth - 9 - itemInfo.length(), ' ') << "  ║\n";
+                cout << padLeft("║         ") << "\033[97m" << itemInfo << "\033[96m" << string(Layout::TABLE_WIDTH - 9 - itemInfo.length(), ' ') << "  ║\n";
             }
             cout << padLeft("║") << centerText("") << "║\n";
         }
 
         if (receipts.size() > 5) {
-            string totalInfo = "(Total transactions: " + to_string(receipts.size()) + ")";
+            time_t now = time(nullptr);
+            string totalInfo = "(Total transactions: " + to_string(receipts.size()) + ", last 24h: " +
+                               to_string(receiptTimeIndex.countInRange(now - 24 * 60 * 60, now + 1)) + ")";
             cout << padLeft("║") << "\033[90m" << centerText(totalInfo) << "\033[96m" << " ║\n";
             cout << padLeft("║") << centerText("") << " ║\n";
         }
@@ -2554,25 +2859,96 @@ void printStockReport() {
     cout << padLeft("║") << "\033[93m" << centerText("📋 REPORT GENERATED SUCCESSFULLY!") << "\033[92m" << "  ║" << "\n";
     cout << padLeft("║") << "\033[96m" <<  centerText("Press any key to go back to the menu...") << "\033[92m" << "║" << "\n";
     cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
-    _getch(); // Wait for user input
+    reportTimer.stop();
+    readKey(); // Wait for user input
 }
+// Page through the purchase history of the logged-in user, newest first
+void viewMyPurchases() {
+
+    if (!currentUser) {
+        cout << "\n" << padLeft("\033[91m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
+        cout << padLeft("║") << "\033[93m" << centerText("❌ ERROR!") << "\033[91m" << "║" << "\n";
+        cout << padLeft("║") << "\033[96m" << centerText("Please login first to see your purchases.") << "\033[91m" << "║" << "\n";
+        cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
+        readKey();
+        return;
+    }
+
+    const string username(currentUser->getUsername());
+    // Only this user's posting list is read, never the whole receipts history
+    const pmr::vector<size_t>& history = userReceiptIndex.getReceipts(username);
+    const size_t pageSize = 5;
+    size_t pageCount = history.empty() ? 1 : (history.size() + pageSize - 1) / pageSize;
+    size_t page = 0;
+
+    while (true) {
+        ScreenRenderer::clearScreen();
+        cout << "\033[96m\033[1m";
+        cout << "\n" << padLeft("╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
+        cout << padLeft("║") << centerText("") << "║\n";
+        cout << padLeft("║") << "\033[93m" << centerText("🧾 MY PURCHASES") << "\033[96m" << "  ║\n";
+        cout << padLeft("║") << "\033[95m" << centerText(username + " | " + to_string(history.size()) + " receipts | $" +
+                                                  salesAnalytics.getRevenueForUser(username).toString() + " spent") << "\033[96m" << "║\n";
+        cout << padLeft("║") << centerText("") << "║\n";
+        cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
+        cout << padLeft("║") << centerText("") << "║\n";
+
+        if (history.empty()) {
+            cout << padLeft("║") << "\033[91m" << centerText("You have not purchased anything yet.") << "\033[96m" << "║\n";
+            cout << padLeft("║") << centerText("") << "║\n";
+        }
+
+        for (size_t k = 0; k < pageSize; ++k) {
+            size_t offset = page * pageSize + k;
+            if (offset >= history.size()) {
+                break;
+            }
+            const Receipt& receipt = receipts[history[history.size() - 1 - offset]];
+
+            time_t transactionTime = receipt.getTransactionTime();
+            tm ptm{};
+            char timeBuf[50] = "[Invalid Time]";
+            if (localtime_s(&ptm, &transactionTime) == 0) {
+                strftime(timeBuf, sizeof(timeBuf), "%Y-%m-%d %H:%M", &ptm);
+            }
+            string receiptInfo = "🧾 Receipt #" + to_string(receipt.getReceiptId()) + " | $" +
+                                 receipt.getTotalPrice().toString() + " | " + string(timeBuf);
+            cout << padLeft("║         ") << "\033[94m" << receiptInfo << "\033[96m" << string(Layout::TABLE_WIDTH - 9 - receiptInfo.length(), ' ') << "  ║\n";
+
+            for (const auto& item : receipt.getItems()) {
+                string itemInfo = "    • " + item.getName() + " x" + to_string(item.quantity) +
+                                  " @ $" + item.unitPrice.toString();
+                if (itemInfo.length() > 72) {
+                    itemInfo = itemInfo.substr(0, 69) + "...";
+                }
+                cout << padLeft("║         ") << "\033[97m" << itemInfo << "\033[96m" << string(Layout::TABLE_WIDTH - 9 - itemInfo.length(), ' ') << "  ║\n";
+            }
+            cout << padLeft("║") << centerText("") << "║\n";
+        }
+
+        cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
+        string pageInfo = "Page " + to_string(page + 1) + " of " + to_string(pageCount) +
+                          "  |  [N] Next  [P] Previous  [Q] Back";
+        cout << padLeft("║") << "\033[92m" << centerText(pageInfo) << "\033[96m" << "║\n";
+        cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\n";
+        cout << "\033[0m";
+
+        int key = readKey();
+        if ((key == 'n' || key == 'N') && page + 1 < pageCount) {
+            page++;
+        } else if ((key == 'p' || key == 'P') && page > 0) {
+            page--;
+        } else if (key == 'q' || key == 'Q' || key == 27) {
+            return;
+        }
+    }
+}
+
 void viewCart() {
-    system("cls");
-    string username = (currentUser != nullptr) ? currentUser->getUsername() : " ";
-    // Dynamic centering setup
-    const int tableWidth = 82;     // inside width of box
-    const int terminalWidth = 164; // adjust for your terminal width
-    int leftPadding = (terminalWidth - (tableWidth + 4)) / 2; // +4 for borders
-
-    auto padLeft = [&](const string& text) {
-        return string(leftPadding, ' ') + text;
-    };
-    
-    auto centerText = [&](const string& text) {
-        int spacesLeft = (tableWidth - text.size()) / 2;
-        int spacesRight = tableWidth - text.size() - spacesLeft;
-        return string(spacesLeft, ' ') + text + string(spacesRight, ' ');
-    };
+    ScreenRenderer::clearScreen();
+    string username = (currentUser != nullptr) ? string(currentUser->getUsername()) : " ";
+
+    vector<CartStore::Line> cart = carts.getCart(username);
     // Check if cart is empty
     if (cart.empty()) {
         cout << "\n" << padLeft("\033[91m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
@@ -2595,7 +2971,7 @@ void viewCart() {
     cout << "        ";          // Print spaces to erase
     cout << "\b\b\b\b\b\b\b\b";  // Move cursor back again to the start       
 
-    double total = 0;
+    Money total;
 
     // Cart items display with enhanced styling
     cout << "\033[96m\033[1m";
@@ -2610,9 +2986,13 @@ void viewCart() {
 
     // Display each cart item
     cout << fixed << setprecision(2);
-    for (auto &c : cart) {
-        double itemTotal = c.first.getPrice() * c.second;
-        string productName = c.first.getName();
+    for (const auto& c : cart) {
+        const Stock* item = findStockById(c.stockId);
+        if (!item) {
+            continue; // product was removed from the catalog
+        }
+        Money itemTotal = item->getPrice() * c.quantity;
+        string productName = item->getName();
         
         // Truncate long product names
         if (productName.length() > 30) {
@@ -2620,9 +3000,9 @@ void viewCart() {
         }
         
         cout << padLeft("║") << "\033[92m  " << productName << string(37- productName.length(), ' ') 
-             << "\033[93m" << setw(3) << c.second << string(10, ' ')
-             << "\033[95m$" << setw(8) << c.first.getPrice() << string(7, ' ')
-             << "\033[97m$" << setw(8) << itemTotal << string(5, ' ') << "\033[96m║\n";
+             << "\033[93m" << setw(3) << c.quantity << string(10, ' ')
+             << "\033[95m$" << setw(8) << item->getPrice().toString() << string(7, ' ')
+             << "\033[97m$" << setw(8) << itemTotal.toString() << string(5, ' ') << "\033[96m║\n";
         
         total += itemTotal;
     }
@@ -2631,7 +3011,7 @@ void viewCart() {
     cout << padLeft("║") << centerText("") << "║\n";
     
     // Total section with enhanced styling
-    cout << padLeft("║") << "\033[93m" << "  TOTAL AMOUNT: " << "\033[92m\033[1m$" << setw(10) << total << "\033[96m" << string(55, ' ') << "║\n";
+    cout << padLeft("║") << "\033[93m" << "  TOTAL AMOUNT: " << "\033[92m\033[1m$" << setw(10) << total.toString() << "\033[96m" << string(55, ' ') << "║\n";
     cout << padLeft("║") << centerText("") << "║\n";
     cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\n";
     cout << "\033[0m";
@@ -2669,19 +3049,23 @@ void viewCart() {
         case 1:
             // Continue shopping logic here
             cout << "\n" << padLeft("\033[96m🛍️ Redirecting to shopping...\033[0m");
+            cout.flush();
             Sleep(1000);
             // Call shopping function here
             return addItemToCart(); // Assuming this function allows adding items to the cart
         case 2:
             // Checkout logic here
             cout << "\n" << padLeft("\033[92m💳 Proceeding to checkout...\033[0m");
+            cout.flush();
             Sleep(1000);
             checkoutCart(username); 
             break; // Exit to allow checkoutCart to be called externally
         case 3:
             // Clear cart logic
-            cart.clear();
+            carts.clear(username);
+            checkoutEngine.releaseAll(username);
             cout << "\n" << padLeft("\033[93m🗑️ Cart cleared successfully!\033[0m");
+            cout.flush();
             Sleep(1000);
             break;
         case 0:
@@ -2697,23 +3081,8 @@ void viewCart() {
 }
 
 void checkoutCart(const string& username) {
-    system("cls");
-    
-    // Dynamic centering setup
-    const int tableWidth = 82;     // inside width of box
-    const int terminalWidth = 164; // adjust for your terminal width
-    int leftPadding = (terminalWidth - (tableWidth + 4)) / 2; // +4 for borders
-
-    auto padLeft = [&](const string& text) {
-        return string(leftPadding, ' ') + text;
-    };
+    ScreenRenderer::clearScreen();
     
-    auto centerText = [&](const string& text) {
-        int spacesLeft = (tableWidth - text.size()) / 2;
-        int spacesRight = tableWidth - text.size() - spacesLeft;
-        return string(spacesLeft, ' ') + text + string(spacesRight, ' ');
-    };
-
 
     // Enhanced checkout cart design with dynamic centering
     cout << "\033[96m\033[1m";
@@ -2724,6 +3093,7 @@ void checkoutCart(const string& username) {
     cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\n";
     cout << "\033[0m";
 
+    vector<CartStore::Line> cart = carts.getCart(username);
     // Check if cart is empty
     if (cart.empty()) {
         cout << "\n" << padLeft("\033[91m╔═══════════════════════════════════════════════════════════╗") << "\n";
@@ -2744,37 +3114,36 @@ void checkoutCart(const string& username) {
     cout << padLeft("║") << centerText("") << "║\n";
     cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
     // Table header
-    printf("%s║ %s%-4s │ %-30s │ %-8s │ %-10s │ %-10s%s       ║%s\n",
-           string(leftPadding, ' ').c_str(), "\033[94m\033[1m",
-           "ID", "PRODUCT NAME", "QUANTITY", "UNIT PRICE", "TOTAL",
-           "\033[96m", "\033[0m");
+    using CartTable = Layout::TableLayout<
+        Layout::Column<6, Layout::Align::Left, Layout::Color::White>,
+        Layout::Column<32, Layout::Align::Left, Layout::Color::Blue>,
+        Layout::Column<10, Layout::Align::Center, Layout::Color::Green>,
+        Layout::Column<12, Layout::Align::Right, Layout::Color::Yellow>,
+        Layout::Column<12, Layout::Align::Right, Layout::Color::Red>>;
+    cout << "\033[1m";
+    CartTable::header(cout, Layout::Color::Blue, "ID", "PRODUCT NAME", "QUANTITY", "UNIT PRICE", "TOTAL");
     
     // cout << padLeft("║") << "\033[94m" << string(4, '─') << "┼" << string(30, '─') << "┼" 
     //      << string(8, '─') << "┼" << string(10, '─') << "┼" << string(10, '─') << "\033[96m" << string(15, ' ') << " ║\n";
     cout << padLeft("\033[96m╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
 
-    double cartTotal = 0.0;
+    Money cartTotal;
     for (const auto& cart_item : cart) {
-        double itemTotal = cart_item.first.getPrice() * cart_item.second;
+        const Stock* item = findStockById(cart_item.stockId);
+        if (!item) {
+            continue; // product was removed from the catalog
+        }
+        Money itemTotal = item->getPrice() * cart_item.quantity;
         cartTotal += itemTotal;
         
-        printf("%s║ %s%-4d%s │ %s%-30s%s │ %s%-8d%s │ %s$%-9.2f%s │ %s$%-9.2f%s       ║%s\n",
-               string(leftPadding, ' ').c_str(), 
-               "\033[97m", cart_item.first.getId(), "\033[96m",
-               "\033[94m", 
-               cart_item.first.getName().length() > 30 ? 
-               (cart_item.first.getName().substr(0, 27) + "...").c_str() : 
-               cart_item.first.getName().c_str(), "\033[96m",
-               "\033[92m", cart_item.second, "\033[96m",
-               "\033[93m", cart_item.first.getPrice(), "\033[96m",
-               "\033[91m", itemTotal, "\033[96m", "\033[0m");
+        CartTable::row(cout, item->getId(), item->getName(), cart_item.quantity, item->getPrice(), itemTotal);
     }
 
     cout << padLeft("\033[96m║") << centerText("") << "║\n";
     cout << padLeft("\033[96m╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
-    printf("%s\033[96m║%s                             %sGRAND TOTAL: %s$%-10.2f%s                             ║%s\n",
-           string(leftPadding, ' ').c_str(), "\033[96m", "\033[93m\033[1m", 
-           "\033[91m\033[1m", cartTotal, "\033[96m", "\033[0m");
+    ScreenRenderer::printf("%s\033[96m║%s                             %sGRAND TOTAL: %s$%-10s%s                             ║%s\n",
+           Layout::margin(), "\033[96m", "\033[93m\033[1m", 
+           "\033[91m\033[1m", cartTotal.toString().c_str(), "\033[96m", "\033[0m");
     cout << padLeft("\033[96m╚══════════════════════════════════════════════════════════════════════════════════╝") << "\n";
     cout << "\033[0m";
 
@@ -2821,46 +3190,74 @@ void checkoutCart(const string& username) {
     cout << "        ";          // Print spaces to erase
     cout << "\b\b\b\b\b\b\b\b";  // Move cursor back again to the start  
     int receiptId = ExcelUtil::getNextReceiptId(receipts);
-    vector<pair<Stock, int>> purchasedItemsForReceipt;
-    double totalCartPrice = 0.0;
-    bool transactionSuccessful = true;
+    vector<Receipt::Item> purchasedItemsForReceipt;
     vector<string> failedItems;
 
-    for (auto& cart_item : cart) {
-        int id = cart_item.first.getId();
-        int quantityToBuy = cart_item.second;
-
-        auto stock_it = find_if(stocks.begin(), stocks.end(), [id](const Stock& s){
-            return s.getId() == id;
-        });
+    // Reserve every line through the engine: the whole cart is applied or nothing is
+    vector<CheckoutEngine::Line> lines;
+    lines.reserve(cart.size());
+    for (const auto& cart_item : cart) {
+        lines.push_back({cart_item.stockId, cart_item.quantity});
+    }
 
-        if (stock_it != stocks.end()) {
-            if (stock_it->getQuantity() >= quantityToBuy) {
-                stock_it->setQuantity(stock_it->getQuantity() - quantityToBuy);
-                purchasedItemsForReceipt.push_back({*stock_it, quantityToBuy});
-                totalCartPrice += stock_it->getPrice() * quantityToBuy;
+    static LatencyHistogram& checkoutLatency = Metrics::histogram("checkout");
+    Metrics::ScopedTimer checkoutTimer(checkoutLatency);
+    Trace::Span checkoutSpan("checkout_cart");
+    vector<int> failedIds;
+    pmr::vector<Stock> changedStocks; // written to the catalog in one commit
+    bool transactionSuccessful = checkoutEngine.checkout(username, lines, failedIds);
+
+    if (transactionSuccessful) {
+        for (const auto& line : lines) {
+            auto stock_it = find_if(stocks.begin(), stocks.end(), [&line](const Stock& s){
+                return s.getId() == line.stockId;
+            });
+            if (stock_it != stocks.end()) {
+                int oldQuantity = stock_it->getQuantity();
+                stock_it->setQuantity(checkoutEngine.getQuantity(line.stockId));
+                stockAlerts.onQuantityChange(*stock_it, oldQuantity);
+                changedStocks.push_back(*stock_it);
+                purchasedItemsForReceipt.push_back(Receipt::makeItem(*stock_it, line.quantity));
+            }
+        }
+    } else {
+        for (int id : failedIds) {
+            auto stock_it = find_if(stocks.begin(), stocks.end(), [id](const Stock& s){
+                return s.getId() == id;
+            });
+            if (stock_it != stocks.end()) {
+                failedItems.push_back(stock_it->getName() + " (Available: " +
+                                    to_string(checkoutEngine.getAvailable(id)) + ")");
             } else {
-                failedItems.push_back(stock_it->getName() + " (Available: " + 
-                                    to_string(stock_it->getQuantity()) + ")");
-                transactionSuccessful = false;
+                failedItems.push_back("Item ID " + to_string(id) + " (Not found)");
             }
-        } else {
-            failedItems.push_back("Item ID " + to_string(id) + " (Not found)");
-            transactionSuccessful = false;
         }
     }
 
     if (transactionSuccessful && !purchasedItemsForReceipt.empty()) {
         // Complete success
-        Receipt newReceipt(receiptId, purchasedItemsForReceipt, username);
-        receipts.push_back(newReceipt);
-
-        ExcelUtil::writeStockToFile("data/stock.xlsx", stocks);
-        ExcelUtil::writeTransactionsToFile("data/transactions.xlsx", receipts);
+        receipts.emplace_back(receiptId, purchasedItemsForReceipt, username);
+        const Receipt& newReceipt = receipts.back();
+        salesAnalytics.addReceipt(newReceipt);
+        topSellers.addReceipt(newReceipt);
+        receiptTimeIndex.add(newReceipt, receipts.size() - 1);
+        userReceiptIndex.add(username, receipts.size() - 1);
+        restockPlanner.addReceipt(newReceipt);
+
+        bool catalogSaved = stockDb.putAll(changedStocks);
+        bool receiptSaved = ReceiptStore::append(RECEIPT_STORE_FILE, receipts);
+        checkoutTimer.stop();
+        checkoutSpan.stop();
 
         cout << "\n" << padLeft("\033[92m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
         cout << padLeft("║") << "\033[93m" << centerText("✅ CHECKOUT SUCCESSFUL!") << "\033[92m" << " ║" << "\n";
         cout << padLeft("║") << "\033[96m" << centerText("Your purchase has been completed") << "\033[92m" << "║" << "\n";
+        if (!catalogSaved) {
+            cout << padLeft("║") << "\033[91m" << centerText("⚠️ New stock levels were not saved to the catalog file") << "\033[92m" << "║" << "\n";
+        }
+        if (!receiptSaved) {
+            cout << padLeft("║") << "\033[91m" << centerText("⚠️ The receipt was not saved to the receipt store") << "\033[92m" << "║" << "\n";
+        }
         cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
         
         // Receipt details
@@ -2871,80 +3268,26 @@ void checkoutCart(const string& username) {
         cout << padLeft("║") << centerText("") << "║\n";
         cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
         
-        printf("%s║ %sReceipt ID:%s %-10d                    %sCustomer:%s %-20s%s         ║%s\n",
-               string(leftPadding, ' ').c_str(), "\033[94m", "\033[97m", newReceipt.getReceiptId(),
+        ScreenRenderer::printf("%s║ %sReceipt ID:%s %-10d                    %sCustomer:%s %-20s%s         ║%s\n",
+               Layout::margin(), "\033[94m", "\033[97m", newReceipt.getReceiptId(),
                "\033[94m", "\033[97m", username.c_str(), "\033[96m", "\033[0m");
         
-        printf("%s\033[96m║%s %sTOTAL AMOUNT: %s$%-10.2f%s                                                        ║%s\n",
-               string(leftPadding, ' ').c_str(), "\033[96m", "\033[93m\033[1m", 
-               "\033[91m\033[1m", newReceipt.getTotalPrice(), "\033[96m", "\033[0m");
+        ScreenRenderer::printf("%s\033[96m║%s %sTOTAL AMOUNT: %s$%-10s%s                                                        ║%s\n",
+               Layout::margin(), "\033[96m", "\033[93m\033[1m", 
+               "\033[91m\033[1m", newReceipt.getTotalPrice().toString().c_str(), "\033[96m", "\033[0m");
         
         cout << padLeft("\033[96m╚══════════════════════════════════════════════════════════════════════════════════╝") << "\n";
         cout << "\033[0m";
 
-        cart.clear();
-        
-    } else if (!purchasedItemsForReceipt.empty()) {
-        // Partial success
-        Receipt newReceipt(receiptId, purchasedItemsForReceipt, username);
-        receipts.push_back(newReceipt);
-
-        ExcelUtil::writeStockToFile("data/stock.xlsx", stocks);
-        ExcelUtil::writeTransactionsToFile("data/transactions.xlsx", receipts);
-
-        cout << "\n" << padLeft("\033[93m╔═══════════════════════════════════════════════════════════╗") << "\n";
-        cout << padLeft("║") << "\033[96m" << "              ⚠️  PARTIAL CHECKOUT                   " << "\033[93m" << "     ║" << "\n";
-        cout << padLeft("║") << "\033[94m" << "         Some items purchased, others failed            " << "\033[93m" << "  ║" << "\n";
-        cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
-
-        // Show failed items
-        if (!failedItems.empty()) {
-            cout << "\033[91m\033[1m";
-            cout << "\n" << padLeft("╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
-            cout << padLeft("║") << centerText("") << "║\n";
-            cout << padLeft("║") << "\033[93m" << centerText("❌ FAILED ITEMS") << "\033[91m" << "  ║\n";
-            cout << padLeft("║") << centerText("") << "║\n";
-            cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
-            
-            for (const auto& failedItem : failedItems) {
-                printf("%s║ %s• %-70s%s     ║%s\n",
-                       string(leftPadding, ' ').c_str(), "\033[94m",
-                       failedItem.length() > 70 ? (failedItem.substr(0, 67) + "...").c_str() : failedItem.c_str(),
-                       "\033[91m", "\033[0m");
-            }
-            
-            cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\n";
-            cout << "\033[0m";
-        }
-
-        // Show successful receipt
-        cout << "\033[96m\033[1m";
-        cout << "\n" << padLeft("╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
-        cout << padLeft("║") << centerText("") << "║\n";
-        cout << padLeft("║") << "\033[93m" << centerText("🧾 PARTIAL RECEIPT") << "\033[96m" << "  ║\n";
-        cout << padLeft("║") << centerText("") << "║\n";
-        cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
-        
-        printf("%s║ %sReceipt ID:%s %-10d                    %sCustomer:%s %-20s%s      ║%s\n",
-               string(leftPadding, ' ').c_str(), "\033[94m", "\033[97m", newReceipt.getReceiptId(),
-               "\033[94m", "\033[97m", username.c_str(), "\033[96m", "\033[0m");
-        
-        cout << padLeft("║") << centerText("") << "║\n";
-        printf("%s║%s                           %sTOTAL PAID: %s$%-10.2f%s                          ║%s\n",
-               string(leftPadding, ' ').c_str(), "\033[96m", "\033[93m\033[1m", 
-               "\033[91m\033[1m", newReceipt.getTotalPrice(), "\033[96m", "\033[0m");
-        
-        cout << padLeft("║") << centerText("") << "║\n";
-        cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\n";
-        cout << "\033[0m";
-
-        cart.clear();
+        carts.clear(username);
         
     } else {
-        // Complete failure
+        checkoutTimer.stop();
+        checkoutSpan.stop();
+        // Complete failure: nothing was taken from stock
         cout << "\n" << padLeft("\033[91m╔═══════════════════════════════════════════════════════════╗") << "\n";
         cout << padLeft("║") << "\033[93m" << "                ❌ CHECKOUT FAILED!                 " << "\033[91m" << "     ║" << "\n";
-        cout << padLeft("║") << "\033[94m" << "          No items could be successfully purchased       " << "\033[91m" << "║" << "\n";
+        cout << padLeft("║") << "\033[94m" << "      No items were purchased, stock is unchanged        " << "\033[91m" << "║" << "\n";
         cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
 
         // Show failed items
@@ -2957,8 +3300,8 @@ void checkoutCart(const string& username) {
             cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
             
             for (const auto& failedItem : failedItems) {
-                printf("%s║ %s• %-70s%s     ║%s\n",
-                       string(leftPadding, ' ').c_str(), "\033[94m",
+                ScreenRenderer::printf("%s║ %s• %-70s%s     ║%s\n",
+                       Layout::margin(), "\033[94m",
                        failedItem.length() > 70 ? (failedItem.substr(0, 67) + "...").c_str() : failedItem.c_str(),
                        "\033[91m", "\033[0m");
             }
@@ -2967,7 +3310,8 @@ void checkoutCart(const string& username) {
             cout << "\033[0m";
         }
 
-        cart.clear();
+        carts.clear(username);
+        checkoutEngine.releaseAll(username);
     }
 
     cout << "\n" << padLeft("\033[93m📋 Press any key to go back to the menu...\033[0m") << "\n";
@@ -2975,23 +3319,9 @@ void checkoutCart(const string& username) {
 }
 void deleteUser() {
 
-    system("cls");
+    ScreenRenderer::clearScreen();
     string username;
     
-    // Dynamic centering setup
-    const int tableWidth = 82;
-    const int terminalWidth = 164;
-    int leftPadding = (terminalWidth - (tableWidth + 4)) / 2;
-
-    auto padLeft = [&](const string& text) {
-        return string(leftPadding, ' ') + text;
-    };
-    
-    auto centerText = [&](const string& text) {
-        int spacesLeft = (tableWidth - text.size()) / 2;
-        int spacesRight = tableWidth - text.size() - spacesLeft;
-        return string(spacesLeft, ' ') + text + string(spacesRight, ' ');
-    };
 
     string asciiArt[] = {
         " _____       _      _           _              _                 ",
@@ -3004,7 +3334,7 @@ void deleteUser() {
 
     cout << "\n";
     for (const string& line : asciiArt) {
-        cout << padLeft(" " + centerText(line) + " ") << endl;
+        cout << padLeft(" ") << centerText(line) << " \n";
     }
     cout << "\n";
 
@@ -3044,9 +3374,8 @@ void deleteUser() {
     cout << "        ";          // Print spaces to erase
     cout << "\b\b\b\b\b\b\b\b";  // Move cursor back again to the start 
     // Find the user by username
-    auto it = find_if(users.begin(), users.end(), [username](const User& u) {
-        return u.getUsername() == username;
-    });
+    int userPos = userIndex.find(username);
+    auto it = userPos == UserIndex::NOT_FOUND ? users.end() : users.begin() + userPos;
 
     if (it != users.end()) {
         // Prevent deletion of admin account
@@ -3099,24 +3428,41 @@ void deleteUser() {
             cout << "\b\b\b\b\b\b\b\b";  // Move cursor back again to the start 
             
 
+            User removed = *it;
             users.erase(it);
-            ExcelUtil::writeUsersToFile("data/users.xlsx", users);
+            userIndex.erase(username, userPos, users);
+            bool saved = true;
+            try {
+                ExcelUtil::writeUsersToFile("data/users.xlsx", users);
+            } catch (const exception& e) {
+                // Not saved, so not deleted
+                users.insert(users.begin() + userPos, removed);
+                userIndex.rebuild(users);
+                saved = false;
+                cout << "\n" << padLeft("\033[91m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
+                cout << padLeft("║") << "\033[93m" << centerText("❌ NOT SAVED!") << "\033[91m" << " ║\n";
+                cout << padLeft("║") << "\033[96m" << centerText(e.what()) << "\033[91m" << "║\n";
+                cout << padLeft("║") << "\033[94m" << centerText("User account has been kept in system") << "\033[91m" << "║\n";
+                cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
+            }
             
-        // User deleted successfully - Organized table
-        cout << "\n" << padLeft("\033[91m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
-        cout << padLeft("║") << centerText("") << "║\n";
-        cout << padLeft("║") << "\033[93m" << centerText("✅ USER DELETED SUCCESSFULLY!") << "\033[91m" << " ║\n";
-        cout << padLeft("║") << centerText("") << "║\n";
-        cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
-        cout << padLeft("║") << centerText("") << "║\n";
-        cout << padLeft("║") << "\033[96m" << centerText("🗑️  Deletion Summary:") << "\033[91m" << "      ║\n";
-        cout << padLeft("║                        ") << "\033[94m" << "• Username: " << "\033[97m" << username << "\033[91m" << string(45 - username.length(), ' ') << " ║\n";
-        cout << padLeft("║                        ") << "\033[94m" << "• Status: " << "\033[97m" << "PERMANENTLY REMOVED" << "\033[91m" << string(29, ' ') << "║\n";
-        cout << padLeft("║                        ") << "\033[94m" << "• Action: " << "\033[97m" << "DELETION COMPLETED" << "\033[91m" << string(30, ' ') << "║\n";
-        cout << padLeft("║") << centerText("") << "║\n";
-        cout << padLeft("║") << "\033[95m" << centerText("💡 User account has been removed from system database") << "\033[91m" << "  ║\n";
-        cout << padLeft("║") << centerText("") << "║\n";
-        cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
+        if (saved) {
+            // User deleted successfully - Organized table
+            cout << "\n" << padLeft("\033[91m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
+            cout << padLeft("║") << centerText("") << "║\n";
+            cout << padLeft("║") << "\033[93m" << centerText("✅ USER DELETED SUCCESSFULLY!") << "\033[91m" << " ║\n";
+            cout << padLeft("║") << centerText("") << "║\n";
+            cout << padLeft("╠══════════════════════════════════════════════════════════════════════════════════╣") << "\n";
+            cout << padLeft("║") << centerText("") << "║\n";
+            cout << padLeft("║") << "\033[96m" << centerText("🗑️  Deletion Summary:") << "\033[91m" << "      ║\n";
+            cout << padLeft("║                        ") << "\033[94m" << "• Username: " << "\033[97m" << username << "\033[91m" << string(45 - username.length(), ' ') << " ║\n";
+            cout << padLeft("║                        ") << "\033[94m" << "• Status: " << "\033[97m" << "PERMANENTLY REMOVED" << "\033[91m" << string(29, ' ') << "║\n";
+            cout << padLeft("║                        ") << "\033[94m" << "• Action: " << "\033[97m" << "DELETION COMPLETED" << "\033[91m" << string(30, ' ') << "║\n";
+            cout << padLeft("║") << centerText("") << "║\n";
+            cout << padLeft("║") << "\033[95m" << centerText("💡 User account has been removed from system database") << "\033[91m" << "  ║\n";
+            cout << padLeft("║") << centerText("") << "║\n";
+            cout << padLeft("╚══════════════════════════════════════════════════════════════════════════════════╝") << "\033[0m" << "\n";
+        }
         } else {
             // Cancellation message
             cout << "\n" << padLeft("\033[92m╔══════════════════════════════════════════════════════════════════════════════════╗") << "\n";
@@ -3144,5 +3490,5 @@ void deleteUser() {
     
     cout << padLeft("\033[93m📋 Press any key to continue...\033[0m") << "\n";
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
-    _getch();
+    readKey();
 }
\ No newline at end of file